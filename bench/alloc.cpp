@@ -0,0 +1,31 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "alloc.h"
+
+/* Подмена глобальных operator new/delete для подсчёта аллокаций.
+ * Отдельная единица трансляции: иначе GCC встраивает их в вызывающий
+ * код и ложно ругается на free() для памяти из operator new.
+ */
+namespace {
+std::atomic<u64> count{0};
+} /* namespace */
+
+auto Bench::allocCount() -> u64 {
+    return count.load(std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t size) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
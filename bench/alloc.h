@@ -0,0 +1,8 @@
+#pragma once
+
+#include "common/types.h"
+
+namespace Bench {
+/* Сколько раз вызывался глобальный operator new с начала программы */
+auto allocCount() -> u64;
+} /* namespace Bench */
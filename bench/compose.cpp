@@ -0,0 +1,101 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+#include "core/compositor.h"
+
+/* Микробенчмарк сведения строки PPU (Core::Compositor): векторная версия
+ * против скалярной на случайных строках. Заодно проверка: индексы и
+ * sprite-0 hit обеих версий должны совпадать до бита, иначе код выхода
+ * ненулевой.
+ */
+namespace {
+using Line = std::array<u8, Core::Compositor::WIDTH>;
+
+constexpr sz LINES = 64;
+
+/* Строки похожи на настоящие: много прозрачных пикселей, спрайт 0
+ * редко. Бит 5 только у непрозрачных пикселей, как у PPU */
+void fillLines(std::mt19937 &rng, std::array<Line, LINES> &bg,
+               std::array<Line, LINES> &spr) {
+    for (sz i = 0; i < LINES; ++i) {
+        for (sz x = 0; x < Core::Compositor::WIDTH; ++x) {
+            bg[i][x] = static_cast<u8>(rng() & 0x0F);
+
+            const u32 r = rng();
+            u8 s = (r % 4 == 0) ? static_cast<u8>((r >> 8) & 0x1F) : 0;
+            if ((s & 0x03) != 0 && (r >> 16) % 64 == 0)
+                s |= 0x20;
+            spr[i][x] = s;
+        }
+    }
+}
+} /* namespace */
+
+int main(int argc, char *argv[]) {
+    const u64 rounds =
+        (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 20000ull;
+
+    std::mt19937 rng(0x4E45535Au);
+    std::array<Line, LINES> bg{};
+    std::array<Line, LINES> spr{};
+    Line out{};
+    Line ref{};
+
+    /* Все комбинации битов PPUMASK, от которых зависит сведение */
+    u64 lines = 0;
+    for (u32 seed = 0; seed < 16; ++seed) {
+        fillLines(rng, bg, spr);
+        for (u8 mask = 0; mask < 0x20; mask = static_cast<u8>(mask + 2)) {
+            for (sz i = 0; i < LINES; ++i, ++lines) {
+                const i32 hit = Core::Compositor::compose(
+                    bg[i].data(), spr[i].data(), mask, out.data());
+                const i32 refHit = Core::Compositor::composeScalar(
+                    bg[i].data(), spr[i].data(), mask, ref.data());
+
+                if (hit != refHit || out != ref) {
+                    std::fprintf(stderr,
+                                 "mismatch (%s): mask %02X line %zu, "
+                                 "hit %d / %d\n",
+                                 Core::Compositor::backend(), mask, i, hit,
+                                 refHit);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    const auto measure = [&](auto &&fn) {
+        u64 sink = 0;
+        const auto start = clock::now();
+        for (u64 r = 0; r < rounds; ++r) {
+            const sz i = r % LINES;
+            sink += static_cast<u64>(
+                fn(bg[i].data(), spr[i].data(), u8{0x1E}, out.data()) + 1);
+            sink += out[r & 0xFF];
+        }
+        const f64 sec =
+            std::chrono::duration<f64>(clock::now() - start).count();
+        const f64 pixels =
+            static_cast<f64>(rounds * Core::Compositor::WIDTH);
+        return std::make_pair((sec > 0.0) ? pixels / sec : 0.0, sink);
+    };
+
+    const auto simd = measure(Core::Compositor::compose);
+    const auto scalar = measure(Core::Compositor::composeScalar);
+
+    std::printf("backend: %s\nchecked lines: %llu (identical)\n"
+                "%s pixels/s: %.2f M\nscalar pixels/s: %.2f M\n"
+                "speedup: %.2fx\n(sink %llu)\n",
+                Core::Compositor::backend(),
+                static_cast<unsigned long long>(lines),
+                Core::Compositor::backend(), simd.first / 1e6,
+                scalar.first / 1e6,
+                (scalar.first > 0.0) ? simd.first / scalar.first : 0.0,
+                static_cast<unsigned long long>(simd.second + scalar.second));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,77 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "core/cpu.h"
+#include "core/mem.h"
+
+/* Микробенчмарк интерпретатора 6502: программа крутится в RAM без
+ * PPU/APU/маппера, так что измеряется только декодирование и исполнение.
+ */
+namespace {
+constexpr u16 PROGRAM_BASE = 0x0200;
+
+/* clang-format off */
+constexpr std::array<u8, 37> PROGRAM = {
+    0xA2, 0x00,       /* $0200 start: LDX #$00    */
+    0xB5, 0x10,       /* $0202 loop:  LDA $10,X   */
+    0x18,             /* $0204        CLC         */
+    0x69, 0x03,       /* $0205        ADC #$03    */
+    0x95, 0x10,       /* $0207        STA $10,X   */
+    0x45, 0x20,       /* $0209        EOR $20     */
+    0x0A,             /* $020B        ASL A       */
+    0x66, 0x21,       /* $020C        ROR $21     */
+    0xA0, 0x04,       /* $020E        LDY #$04    */
+    0xB1, 0x30,       /* $0210        LDA ($30),Y */
+    0x9D, 0x00, 0x03, /* $0212        STA $0300,X */
+    0x20, 0x20, 0x02, /* $0215        JSR sub     */
+    0xE8,             /* $0218        INX         */
+    0xE0, 0x40,       /* $0219        CPX #$40    */
+    0xD0, 0xE5,       /* $021B        BNE loop    */
+    0x4C, 0x00, 0x02, /* $021D        JMP start   */
+    0x48,             /* $0220 sub:   PHA         */
+    0xE6, 0x22,       /* $0221        INC $22     */
+    0x68,             /* $0223        PLA         */
+    0x60,             /* $0224        RTS         */
+};
+/* clang-format on */
+} /* namespace */
+
+int main(int argc, char *argv[]) {
+    const u64 count =
+        (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 50000000ull;
+
+    Core::Memory mem;
+    Core::CPU cpu(&mem);
+
+    Core::Memory::State memState{};
+    for (sz i = 0; i < PROGRAM.size(); ++i)
+        memState.ram[PROGRAM_BASE + i] = PROGRAM[i];
+    memState.ram[0x30] = 0x00;
+    memState.ram[0x31] = 0x04;
+    mem.loadState(memState);
+
+    Core::CPU::State cpuState{};
+    cpuState.regs.PC = PROGRAM_BASE;
+    cpuState.regs.P = Core::CPU::C6502::U | Core::CPU::C6502::I;
+    cpu.loadState(cpuState);
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    u64 cycles = 0;
+    for (u64 i = 0; i < count; ++i) {
+        cpu.exec();
+        cycles += cpu.c.op_cycles;
+    }
+
+    const f64 sec = std::chrono::duration<f64>(clock::now() - start).count();
+    const f64 ips = (sec > 0.0) ? static_cast<f64>(count) / sec : 0.0;
+
+    std::printf("instructions: %llu\ncycles: %llu\ntime: %.3f s\n"
+                "instructions/s: %.2f M\n",
+                static_cast<unsigned long long>(count),
+                static_cast<unsigned long long>(cycles), sec, ips / 1e6);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,397 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core/console.h"
+#include "core/vecenv.h"
+
+#include "alloc.h"
+
+/* Бенчмарк всей системы: гоняет ROM-ы без окна и звука и пишет JSON
+ * с пропускной способностью CPU/PPU/APU/маппера. Аллокации считаются
+ * подменой глобального operator new (alloc.cpp).
+ */
+namespace {
+void printUsage(const char *exe) {
+    std::fprintf(stderr,
+                 "Usage: %s <rom.nes>... [--frames N] [--mappers <dir>] "
+                 "[--region ntsc|pal|dendy] [--lua-mappers] [--indexed] "
+                 "[--envs N] [--run-ahead N] [--out file]\n",
+                 exe);
+}
+
+auto findMapperDir(const char *argv0) -> std::filesystem::path {
+    std::error_code ec;
+    const std::filesystem::path exeDir =
+        std::filesystem::absolute(argv0, ec).parent_path();
+
+    const std::vector<std::filesystem::path> dirs = {
+        exeDir / "mappers", exeDir / ".." / "mappers",
+        std::filesystem::current_path(ec) / "mappers"};
+
+    for (const auto &dir : dirs) {
+        if (std::filesystem::is_directory(dir, ec))
+            return dir.lexically_normal();
+    }
+
+    return "mappers/";
+}
+
+auto parseRegion(const std::string &name, Core::PPU::Region &region) -> bool {
+    if (name == "ntsc")
+        region = Core::PPU::Region::NTSC;
+    else if (name == "pal")
+        region = Core::PPU::Region::PAL;
+    else if (name == "dendy")
+        region = Core::PPU::Region::DENDY;
+    else
+        return false;
+
+    return true;
+}
+
+auto jsonString(const std::string &s) -> std::string {
+    std::string out = "\"";
+    for (const char ch : s) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += ch;
+        } else if (static_cast<unsigned char>(ch) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", ch);
+            out += buf;
+        } else
+            out += ch;
+    }
+    return out + "\"";
+}
+
+auto perSec(u64 count, f64 sec) -> f64 {
+    return (sec > 0.0) ? static_cast<f64>(count) / sec : 0.0;
+}
+
+using clock = std::chrono::steady_clock;
+
+auto elapsed(clock::time_point start) -> f64 {
+    return std::chrono::duration<f64>(clock::now() - start).count();
+}
+
+struct Result {
+    std::string rom;
+    u8 mapper{0};
+    bool nativeMapper{false};
+
+    /* Вся система */
+    f64 seconds{0.0};
+    u64 instructions{0};
+    u64 ppuDots{0};
+    u64 apuCycles{0};
+    u64 luaCalls{0};
+    u64 allocs{0};
+
+    /* PPU и APU отдельно, на тех же объёмах */
+    f64 ppuSeconds{0.0};
+    f64 apuSeconds{0.0};
+
+    /* Снимки состояния (Console::saveSnapshot/loadSnapshot) */
+    u64 snapshots{0};
+    sz snapshotBytes{0};
+    f64 saveSeconds{0.0};
+    f64 loadSeconds{0.0};
+
+    /* Console::stateHash() столько же раз, сколько снимков */
+    f64 hashSeconds{0.0};
+    u64 hashSink{0};
+
+    /* Console::runFrameAhead: runAhead спекулятивных кадров на кадр */
+    u32 runAhead{0};
+    f64 runAheadSeconds{0.0};
+    u64 runAheadAllocs{0};
+
+    /* Перемотка: runFrameMuted(false), кадры без звука и картинки */
+    f64 skipSeconds{0.0};
+
+    /* VecEnv: envs консолей, frames шагов */
+    sz envs{0};
+    f64 envSeconds{0.0};
+};
+
+auto runRom(const std::filesystem::path &romPath,
+            const std::filesystem::path &mapperDir, Core::PPU::Region region,
+            bool luaMappers, bool indexed, u32 runAhead, u64 frames)
+    -> Result {
+    Core::Console console;
+    console.luaMappers = luaMappers;
+    console.setRegion(region);
+    console.loadRom(romPath, mapperDir);
+    console.ppu->indexedOutput = indexed;
+
+    Result r;
+    r.rom = romPath.string();
+    r.mapper = console.mapper->mapperNumber;
+    r.nativeMapper = console.mapper->isNative();
+
+    const auto &sched = console.getScheduler();
+    const u64 dots0 = sched.getPpuDots();
+    const u64 apu0 = sched.getApuCycle();
+    const u64 lua0 = console.mapper->getCallCount();
+    const u64 alloc0 = Bench::allocCount();
+
+    const auto start = clock::now();
+    for (u64 i = 0; i < frames; ++i) {
+        if (!console.runFrame())
+            throw std::runtime_error("[BENCH]: CPU застрял на кадре " +
+                                     std::to_string(i));
+        console.apu->samples.clear();
+    }
+    r.seconds = elapsed(start);
+
+    r.allocs = Bench::allocCount() - alloc0;
+    r.instructions = console.getInstructionCount();
+    r.ppuDots = sched.getPpuDots() - dots0;
+    r.apuCycles = sched.getApuCycle() - apu0;
+    r.luaCalls = console.mapper->getCallCount() - lua0;
+
+    /* Run-ahead с того же места: цена кадра с откатом */
+    if (runAhead > 0) {
+        const u64 raAlloc0 = Bench::allocCount();
+        const auto raStart = clock::now();
+        for (u64 i = 0; i < frames; ++i) {
+            if (!console.runFrameAhead(runAhead))
+                throw std::runtime_error("[BENCH]: CPU застрял на кадре " +
+                                         std::to_string(i));
+            console.apu->samples.clear();
+        }
+        r.runAheadSeconds = elapsed(raStart);
+        r.runAheadAllocs = Bench::allocCount() - raAlloc0;
+        r.runAhead = runAhead;
+    }
+
+    const auto skipStart = clock::now();
+    for (u64 i = 0; i < frames; ++i) {
+        if (!console.runFrameMuted(false))
+            throw std::runtime_error("[BENCH]: CPU застрял на кадре " +
+                                     std::to_string(i));
+    }
+    r.skipSeconds = elapsed(skipStart);
+
+    /* Сохранение и загрузка снимка; загрузка того же снимка ничего не
+     * меняет, так что замеры ниже идут с того же состояния */
+    std::vector<u8> snapshot;
+    r.snapshots = std::max<u64>(frames, 1);
+    const auto saveStart = clock::now();
+    for (u64 i = 0; i < r.snapshots; ++i)
+        console.saveSnapshot(snapshot);
+    r.saveSeconds = elapsed(saveStart);
+    r.snapshotBytes = snapshot.size();
+
+    const auto loadStart = clock::now();
+    for (u64 i = 0; i < r.snapshots; ++i)
+        console.loadSnapshot(snapshot);
+    r.loadSeconds = elapsed(loadStart);
+
+    const auto hashStart = clock::now();
+    for (u64 i = 0; i < r.snapshots; ++i)
+        r.hashSink ^= console.stateHash().combined();
+    r.hashSeconds = elapsed(hashStart);
+
+    /* PPU без CPU: столько же dot-ов с того же состояния */
+    const auto ppuStart = clock::now();
+    console.ppu->r.run(r.ppuDots);
+    r.ppuSeconds = elapsed(ppuStart);
+
+    /* APU без CPU: кадрами, как его вызывает Console::runFrame */
+    const u64 apuFrame = (frames > 0) ? r.apuCycles / frames : 0;
+    const auto apuStart = clock::now();
+    for (u64 i = 0; i < frames && apuFrame > 0; ++i) {
+        console.apu->step(static_cast<u32>(apuFrame));
+        console.apu->endFrame();
+        console.apu->samples.clear();
+    }
+    r.apuSeconds = elapsed(apuStart);
+
+    return r;
+}
+
+/* Шаги VecEnv со случайным вводом */
+void runVecEnv(Result &r, const std::filesystem::path &romPath,
+               const std::filesystem::path &mapperDir,
+               Core::PPU::Region region, bool luaMappers, sz envs,
+               u64 frames) {
+    Core::VecEnv::Config config;
+    config.count = envs;
+    config.region = region;
+    config.luaMappers = luaMappers;
+    Core::VecEnv env(romPath, mapperDir, config);
+
+    std::vector<u8> joy(envs);
+    u32 seed = 1;
+
+    const auto start = clock::now();
+    for (u64 i = 0; i < frames; ++i) {
+        for (u8 &b : joy) {
+            seed = seed * 1664525u + 1013904223u;
+            b = static_cast<u8>(seed >> 24);
+        }
+        env.step(joy.data());
+    }
+    r.envSeconds = elapsed(start);
+    r.envs = envs;
+}
+
+void writeJson(std::FILE *f, const std::vector<Result> &results, u64 frames,
+               const std::string &region) {
+    std::fprintf(f, "{\n  \"frames\": %llu,\n  \"region\": %s,\n",
+                 static_cast<unsigned long long>(frames),
+                 jsonString(region).c_str());
+    std::fprintf(f, "  \"roms\": [");
+
+    for (sz i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        const f64 frameCount = static_cast<f64>(frames);
+
+        std::fprintf(f, "%s\n    {\n", (i == 0) ? "" : ",");
+        std::fprintf(f, "      \"rom\": %s,\n", jsonString(r.rom).c_str());
+        std::fprintf(f, "      \"mapper\": %u,\n", r.mapper);
+        std::fprintf(f, "      \"native_mapper\": %s,\n",
+                     r.nativeMapper ? "true" : "false");
+        std::fprintf(f, "      \"seconds\": %.6f,\n", r.seconds);
+        std::fprintf(f, "      \"fps\": %.2f,\n", perSec(frames, r.seconds));
+        std::fprintf(f, "      \"cpu_instructions_per_sec\": %.0f,\n",
+                     perSec(r.instructions, r.seconds));
+        std::fprintf(f, "      \"ppu_dots_per_sec\": %.0f,\n",
+                     perSec(r.ppuDots, r.seconds));
+        std::fprintf(f, "      \"apu_cycles_per_sec\": %.0f,\n",
+                     perSec(r.apuCycles, r.seconds));
+        std::fprintf(f, "      \"lua_calls_per_sec\": %.0f,\n",
+                     perSec(r.luaCalls, r.seconds));
+        std::fprintf(f, "      \"allocs_per_frame\": %.3f,\n",
+                     (frames > 0) ? static_cast<f64>(r.allocs) / frameCount
+                                  : 0.0);
+        std::fprintf(f, "      \"skipped_fps\": %.2f,\n",
+                     perSec(frames, r.skipSeconds));
+        std::fprintf(f, "      \"ppu_only_dots_per_sec\": %.0f,\n",
+                     perSec(r.ppuDots, r.ppuSeconds));
+        std::fprintf(f, "      \"apu_only_cycles_per_sec\": %.0f,\n",
+                     perSec(r.apuCycles, r.apuSeconds));
+        std::fprintf(f, "      \"snapshot_bytes\": %zu,\n", r.snapshotBytes);
+        std::fprintf(f, "      \"snapshot_saves_per_sec\": %.0f,\n",
+                     perSec(r.snapshots, r.saveSeconds));
+        std::fprintf(f, "      \"snapshot_loads_per_sec\": %.0f,\n",
+                     perSec(r.snapshots, r.loadSeconds));
+
+        /* Доля хэша от времени кадра */
+        const f64 hashSec =
+            r.hashSeconds / static_cast<f64>(std::max<u64>(r.snapshots, 1));
+        const f64 frameSec = (frames > 0) ? r.seconds / frameCount : 0.0;
+        std::fprintf(f, "      \"state_hash_us\": %.3f,\n", hashSec * 1e6);
+        std::fprintf(f, "      \"state_hash_frame_percent\": %.4f",
+                     (frameSec > 0.0) ? hashSec / frameSec * 100.0 : 0.0);
+        if (r.runAhead > 0) {
+            std::fprintf(f, ",\n      \"run_ahead_frames\": %u,\n",
+                         r.runAhead);
+            std::fprintf(f, "      \"run_ahead_fps\": %.2f,\n",
+                         perSec(frames, r.runAheadSeconds));
+            std::fprintf(f, "      \"run_ahead_allocs_per_frame\": %.3f",
+                         (frames > 0) ? static_cast<f64>(r.runAheadAllocs) /
+                                            frameCount
+                                      : 0.0);
+        }
+        if (r.envs > 0) {
+            std::fprintf(f, ",\n      \"vecenv_instances\": %zu,\n",
+                         r.envs);
+            std::fprintf(f, "      \"vecenv_steps_per_sec\": %.0f",
+                         perSec(frames * r.envs, r.envSeconds));
+        }
+        std::fprintf(f, "\n    }");
+    }
+
+    std::fprintf(f, "\n  ]\n}\n");
+}
+} /* namespace */
+
+int main(int argc, char *argv[]) {
+    std::vector<std::filesystem::path> roms;
+    std::filesystem::path mapperDir;
+    std::filesystem::path outPath;
+    std::string regionName = "ntsc";
+    Core::PPU::Region region = Core::PPU::Region::NTSC;
+    u64 frames = 600;
+    bool luaMappers = false;
+    bool indexed = false;
+    sz envs = 0;
+    u32 runAhead = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+
+        if (arg == "--frames" && i + 1 < argc) {
+            frames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--mappers" && i + 1 < argc) {
+            mapperDir = argv[++i];
+        } else if (arg == "--region" && i + 1 < argc) {
+            regionName = argv[++i];
+            if (!parseRegion(regionName, region)) {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--lua-mappers") {
+            luaMappers = true;
+        } else if (arg == "--envs" && i + 1 < argc) {
+            envs = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--run-ahead" && i + 1 < argc) {
+            runAhead = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--indexed") {
+            indexed = true;
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            roms.emplace_back(arg);
+        }
+    }
+
+    if (roms.empty()) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (mapperDir.empty())
+        mapperDir = findMapperDir(argv[0]);
+
+    std::vector<Result> results;
+    try {
+        for (const auto &rom : roms) {
+            std::fprintf(stderr, "%s...\n", rom.string().c_str());
+            results.push_back(
+                runRom(rom, mapperDir, region, luaMappers, indexed, runAhead,
+                       frames));
+            if (envs > 0)
+                runVecEnv(results.back(), rom, mapperDir, region, luaMappers,
+                          envs, frames);
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    std::FILE *out = stdout;
+    if (!outPath.empty()) {
+        out = std::fopen(outPath.string().c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "[BENCH]: Не удалось открыть %s\n",
+                         outPath.string().c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    writeJson(out, results, frames, regionName);
+
+    if (out != stdout)
+        std::fclose(out);
+    return EXIT_SUCCESS;
+}
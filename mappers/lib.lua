@@ -7,6 +7,8 @@ ffi.cdef [[
     void Cartridge_setMirror(void* instance, uint8_t mode);
     void Cartridge_triggerIRQ(void* instance);
     void Cartridge_clearIRQ(void* instance);
+    void Cartridge_mapPRG(void* instance, uint8_t slot, uint32_t offset);
+    void Cartridge_mapCHR(void* instance, uint8_t slot, uint32_t offset);
 ]]
 
 
@@ -81,4 +83,51 @@ function M.clearIRQ()
     ffi.C.Cartridge_clearIRQ(__instance)
 end
 
+-- Состояние для снимков (saveState/loadState)
+
+-- упаковать значения 0-255 в строку (true/false -> 1/0)
+function M.packState(...)
+    local n = select("#", ...)
+    local bytes = {...}
+    for i = 1, n do
+        local v = bytes[i]
+        if v == true then
+            v = 1
+        elseif not v then
+            v = 0
+        end
+        bytes[i] = M.bit_and(v, 0xFF)
+    end
+    return string.char(unpack(bytes, 1, n))
+end
+
+-- распаковать count значений; nil, если строка другой длины
+-- (снимок другого маппера или другой версии скрипта)
+function M.unpackState(data, count)
+    if type(data) ~= "string" or #data ~= count then
+        return nil
+    end
+    return string.byte(data, 1, count)
+end
+
+-- Таблицы банков
+
+-- отобразить count окон PRG по 8 КБ (slot 0-3 = $8000-$E000),
+-- начиная со смещения offset в PRG_ROM
+function M.mapPRG(slot, offset, count)
+    count = count or 1
+    for i = 0, count - 1 do
+        ffi.C.Cartridge_mapPRG(__instance, slot + i, offset + i * 0x2000)
+    end
+end
+
+-- отобразить count окон CHR по 1 КБ (slot 0-7 = $0000-$1C00),
+-- начиная со смещения offset в CHR_ROM
+function M.mapCHR(slot, offset, count)
+    count = count or 1
+    for i = 0, count - 1 do
+        ffi.C.Cartridge_mapCHR(__instance, slot + i, offset + i * 0x0400)
+    end
+end
+
 return M
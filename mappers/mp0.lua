@@ -4,31 +4,29 @@ local lib = require("lib")
 local mp0 = {}
 
 function mp0:init()
-    self.cntBank = prgSize == 0x4000 and 1 or 0
     self.chrRAM = chrSize == 0
 
     if self.chrRAM then
         lib.resizeCHR(0x2000)
     end
-end
 
-function mp0:readPRGAddr(addr)
-    addr = addr - 0x8000
-    if self.cntBank == 1 then
-        addr = lib.bit_and(addr, 0x3FFF)
+    -- 16 КБ PRG зеркалится в $C000-$FFFF
+    if prgSize == 0x4000 then
+        lib.mapPRG(0, 0x0000, 2)
+        lib.mapPRG(2, 0x0000, 2)
+    else
+        lib.mapPRG(0, 0x0000, 4)
     end
-    return addr
+
+    lib.mapCHR(0, 0x0000, 8)
 end
 
-function mp0:readCHRAddr(addr)
-    return lib.bit_and(addr, 0x1FFF)
+-- Регистров нет, таблицы банков не меняются после init()
+function mp0:saveState()
+    return ""
 end
 
-function mp0:writeCHRAddr(addr, value)
-    if self.chrRAM then
-        return lib.bit_and(addr, 0x1FFF)
-    end
-    return nil
+function mp0:loadState(data)
 end
 
-return mp0
+return mp0
\ No newline at end of file
@@ -3,6 +3,31 @@ local lib = require("lib")
 
 local mp1 = {}
 
+local function updateBanks(self)
+    -- PRG: 0/1 - 32 КБ, 2 - первый банк фиксирован, 3 - последний
+    local prgMode = lib.bit_and(lib.bit_rshift(self.ctrl, 2), 0x03)
+
+    if prgMode <= 1 then
+        lib.mapPRG(0, lib.bit_and(self.prgBank, 0xFE) * 0x4000, 4)
+    elseif prgMode == 2 then
+        lib.mapPRG(0, 0x0000, 2)
+        lib.mapPRG(2, self.prgBank * 0x4000, 2)
+    else
+        lib.mapPRG(0, self.prgBank * 0x4000, 2)
+        lib.mapPRG(2, (self.prgBankCount - 1) * 0x4000, 2)
+    end
+
+    -- CHR: 0 - 8 КБ, 1 - два банка по 4 КБ
+    local chrMode = lib.bit_and(lib.bit_rshift(self.ctrl, 4), 0x01)
+
+    if chrMode == 0 then
+        lib.mapCHR(0, lib.bit_and(self.chrBank0, 0xFE) * 0x1000, 8)
+    else
+        lib.mapCHR(0, self.chrBank0 * 0x1000, 4)
+        lib.mapCHR(4, self.chrBank1 * 0x1000, 4)
+    end
+end
+
 local function updateMirror(ctrl)
     local mode = lib.bit_and(ctrl, 0x03)
     if mode == 0 then
@@ -34,35 +59,7 @@ function mp1:init()
     end
 
     updateMirror(self.ctrl)
-end
-
-
-function mp1:readPRGAddr(addr)
-    addr = addr - 0x8000
-
-    local prgMode = lib.bit_and(lib.bit_rshift(self.ctrl, 2), 0x03)
-    local bankOffset
-
-
-    if prgMode <= 1 then
-        bankOffset = lib.bit_and(self.prgBank, 0xFE) * 0x4000
-        return (bankOffset + addr)
-    elseif prgMode == 2 then
-        if addr < 0x4000 then
-            return addr
-        else
-            bankOffset = self.prgBank * 0x4000
-            return (bankOffset + (addr - 0x4000))
-        end
-    else
-        if addr < 0x4000 then
-            bankOffset = self.prgBank * 0x4000
-            return (bankOffset + addr)
-        else
-            local lastBank = (self.prgBankCount - 1) * 0x4000
-            return lastBank + (addr - 0x4000)
-        end
-    end
+    updateBanks(self)
 end
 
 
@@ -71,6 +68,7 @@ function mp1:writePRGAddr(addr, value)
         self.shiftReg = 0x10
         self.ctrl = lib.bit_or(self.ctrl, 0x0C)
         updateMirror(self.ctrl)
+        updateBanks(self)
         return nil
     end
 
@@ -93,39 +91,30 @@ function mp1:writePRGAddr(addr, value)
         end
 
         self.shiftReg = 0x10
+        updateBanks(self)
     end
 
     return nil
 end
 
+function mp1:saveState()
+    return lib.packState(self.shiftReg, self.ctrl, self.chrBank0,
+                         self.chrBank1, self.prgBank)
+end
 
-function mp1:readCHRAddr(addr)
-    addr = lib.bit_and(addr, 0x1FFF)
+function mp1:loadState(data)
+    local shiftReg, ctrl, chrBank0, chrBank1, prgBank = lib.unpackState(data, 5)
+    if shiftReg == nil then return end
 
-    local chrMode = lib.bit_and(lib.bit_rshift(self.ctrl, 4), 0x01)
-    local bankOffset
-    local finalAddr = addr
+    self.shiftReg = shiftReg
+    self.ctrl = ctrl
+    self.chrBank0 = chrBank0
+    self.chrBank1 = chrBank1
+    self.prgBank = prgBank
 
-    if chrMode == 0 then
-        bankOffset = lib.bit_and(self.chrBank0, 0xFE) * 0x1000
-    else
-        if addr < 0x1000 then
-            bankOffset = self.chrBank0 * 0x1000
-        else
-            bankOffset = self.chrBank1 * 0x1000
-            finalAddr = addr - 0x1000
-        end
-    end
-
-    return (bankOffset + finalAddr)
+    updateMirror(self.ctrl)
+    updateBanks(self)
 end
 
 
-function mp1:writeCHRAddr(addr, value)
-    if not self.chrRAM then
-        return nil
-    end
-    return self:readCHRAddr(addr)
-end
-
 return mp1
\ No newline at end of file
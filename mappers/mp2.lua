@@ -3,6 +3,11 @@ local lib = require("lib")
 
 local mp2 = {}
 
+local function updateBanks(self)
+    lib.mapPRG(0, self.prgBank * 0x4000, 2)
+    lib.mapPRG(2, (self.cntBank - 1) * 0x4000, 2)
+end
+
 function mp2:init()
     self.prgBank = 0
     self.cntBank = prgSize / 0x4000
@@ -11,34 +16,27 @@ function mp2:init()
     if self.chrRAM then
         lib.resizeCHR(0x2000)
     end
-end
 
-function mp2:readPRGAddr(addr)
-    addr = addr - 0x8000
-    
-    if addr < 0x4000 then
-        local bankOffset = self.prgBank * 0x4000
-        return bankOffset + addr
-    else
-        local lastBankOffset = (self.cntBank - 1) * 0x4000
-        return lastBankOffset + (addr - 0x4000)
-    end
+    lib.mapCHR(0, 0x0000, 8)
+    updateBanks(self)
 end
 
 function mp2:writePRGAddr(addr, value)
     self.prgBank = lib.maskBank(value, self.cntBank)
+    updateBanks(self)
     return nil
 end
 
-function mp2:readCHRAddr(addr)
-    return lib.bit_and(addr, 0x1FFF)
+function mp2:saveState()
+    return lib.packState(self.prgBank)
 end
 
-function mp2:writeCHRAddr(addr, value)
-    if self.chrRAM then
-        return lib.bit_and(addr, 0x1FFF)
-    end
-    return nil
+function mp2:loadState(data)
+    local prgBank = lib.unpackState(data, 1)
+    if prgBank == nil then return end
+
+    self.prgBank = lib.maskBank(prgBank, self.cntBank)
+    updateBanks(self)
 end
 
 return mp2
\ No newline at end of file
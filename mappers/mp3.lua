@@ -5,7 +5,6 @@ local mp3 = {}
 
 function mp3:init()
     self.chrBank = 0
-    self.prgMask = prgSize == 0x4000 and 0x3FFF or 0x7FFF
     self.chrRAM  = chrSize == 0
 
     if self.chrRAM then
@@ -14,27 +13,34 @@ function mp3:init()
     else
         self.chrBankCount = chrSize / 0x2000
     end
-end
 
-function mp3:readPRGAddr(addr)
-    return lib.bit_and(addr-0x8000, self.prgMask)
+    -- 16 КБ PRG зеркалится в $C000-$FFFF
+    if prgSize == 0x4000 then
+        lib.mapPRG(0, 0x0000, 2)
+        lib.mapPRG(2, 0x0000, 2)
+    else
+        lib.mapPRG(0, 0x0000, 4)
+    end
+
+    lib.mapCHR(0, 0x0000, 8)
 end
 
 function mp3:writePRGAddr(addr, value)
     self.chrBank = lib.maskBank(value, self.chrBankCount)
+    lib.mapCHR(0, self.chrBank * 0x2000, 8)
     return nil
 end
 
-function mp3:readCHRAddr(addr)
-    local bankOffset = self.chrBank*0x2000
-    return bankOffset+addr
+function mp3:saveState()
+    return lib.packState(self.chrBank)
 end
 
-function mp3:writeCHRAddr(addr, value)
-    if self.chrRAM then
-        return addr
-    end
-    return nil
+function mp3:loadState(data)
+    local chrBank = lib.unpackState(data, 1)
+    if chrBank == nil then return end
+
+    self.chrBank = lib.maskBank(chrBank, self.chrBankCount)
+    lib.mapCHR(0, self.chrBank * 0x2000, 8)
 end
 
 return mp3
\ No newline at end of file
@@ -3,6 +3,37 @@ local lib = require("lib")
 
 local mp4 = {}
 
+local function updateBanks(self)
+    local r6 = lib.maskBank(self.regs[7], self.cntPRG)
+    local r7 = lib.maskBank(self.regs[8], self.cntPRG)
+    local lastSecond = lib.maskBank(self.cntPRG-2, self.cntPRG)
+    local last = lib.maskBank(self.cntPRG-1, self.cntPRG)
+    
+    if not self.modePRG then
+        lib.mapPRG(0, r6 * 0x2000)
+        lib.mapPRG(2, lastSecond * 0x2000)
+    else
+        lib.mapPRG(0, lastSecond * 0x2000)
+        lib.mapPRG(2, r6 * 0x2000)
+    end
+    lib.mapPRG(1, r7 * 0x2000)
+    lib.mapPRG(3, last * 0x2000)
+    
+    -- Применяем маску
+    local r0 = lib.maskBank(lib.bit_and(self.regs[1], 0xFE), self.cntCHR)
+    local r1 = lib.maskBank(lib.bit_and(self.regs[2], 0xFE), self.cntCHR)
+    
+    -- Два окна по 2 КБ и четыре по 1 КБ; modeCHR меняет половины
+    local big = self.modeCHR and 4 or 0
+    local small = self.modeCHR and 0 or 4
+    
+    lib.mapCHR(big, r0 * 0x0400, 2)
+    lib.mapCHR(big + 2, r1 * 0x0400, 2)
+    for i = 0, 3 do
+        lib.mapCHR(small + i, lib.maskBank(self.regs[3 + i], self.cntCHR) * 0x0400)
+    end
+end
+
 function mp4:init()
     self.cntPRG = prgSize/0x2000
     self.cntCHR = chrSize/0x0400
@@ -26,78 +57,7 @@ function mp4:init()
     self.irqEnabled = false
     
     lib.clearIRQ()
-end
-
-function mp4:getPRGBank(addr)
-    addr = addr - 0x8000
-    local bankIdx = lib.bit_rshift(addr, 13)
-    
-    local r6 = lib.maskBank(self.regs[7], self.cntPRG)
-    local r7 = lib.maskBank(self.regs[8], self.cntPRG)
-    local lastSecond = lib.maskBank(self.cntPRG-2, self.cntPRG)
-    local last = lib.maskBank(self.cntPRG-1, self.cntPRG)
-    
-    if not self.modePRG then
-        if bankIdx==0 then return r6
-        elseif bankIdx==1 then return r7
-        elseif bankIdx==2 then return lastSecond
-        else return last
-        end
-    else
-        if bankIdx==0 then return lastSecond
-        elseif bankIdx==1 then return r7
-        elseif bankIdx==2 then return r6
-        else return last
-        end
-    end
-end
-
-function mp4:getCHRBank(addr)
-    local bankIdx = lib.bit_rshift(lib.bit_and(addr, 0x1FFF), 10)
-    
-
-    local r0 = lib.bit_and(self.regs[1], 0xFE)
-    local r1 = lib.bit_and(self.regs[2], 0xFE)
-    local r2 = self.regs[3]
-    local r3 = self.regs[4]
-    local r4 = self.regs[5]
-    local r5 = self.regs[6]
-    
-    -- Применяем маску
-    r0 = lib.maskBank(r0, self.cntCHR)
-    r1 = lib.maskBank(r1, self.cntCHR)
-    r2 = lib.maskBank(r2, self.cntCHR)
-    r3 = lib.maskBank(r3, self.cntCHR)
-    r4 = lib.maskBank(r4, self.cntCHR)
-    r5 = lib.maskBank(r5, self.cntCHR)
-    
-    if not self.modeCHR then
-        if bankIdx == 0 then return r0
-        elseif bankIdx == 1 then return r0+1
-        elseif bankIdx == 2 then return r1
-        elseif bankIdx == 3 then return r1+1
-        elseif bankIdx == 4 then return r2
-        elseif bankIdx == 5 then return r3
-        elseif bankIdx == 6 then return r4
-        else return r5
-        end
-    else
-        if bankIdx == 0 then return r2
-        elseif bankIdx == 1 then return r3
-        elseif bankIdx == 2 then return r4
-        elseif bankIdx == 3 then return r5
-        elseif bankIdx == 4 then return r0
-        elseif bankIdx == 5 then return r0+1
-        elseif bankIdx == 6 then return r1
-        else return r1+1
-        end
-    end
-end
-
-function mp4:readPRGAddr(addr)
-    local bank = self:getPRGBank(addr)
-    local offset = lib.bit_and(addr, 0x1FFF)
-    return bank * 0x2000 + offset
+    updateBanks(self)
 end
 
 function mp4:writePRGAddr(addr, value)
@@ -122,6 +82,7 @@ function mp4:writePRGAddr(addr, value)
 
             self.regs[r + 1] = v
         end
+        updateBanks(self)
         
     elseif addr >= 0xA000 and addr <= 0xBFFF then
         if evenAddr then
@@ -156,17 +117,6 @@ function mp4:writePRGAddr(addr, value)
     return nil
 end
 
-function mp4:readCHRAddr(addr)
-    local bank = self:getCHRBank(addr)
-    local offset = lib.bit_and(addr, 0x03FF)
-    return bank*0x0400 + offset
-end
-
-function mp4:writeCHRAddr(addr, value)
-    if not self.chrRAM then return nil end
-    return self:readCHRAddr(addr)
-end
-
 function mp4:step()    
     if self.irqCounter == 0 or self.irqReload then
         self.irqCounter = self.irqLatch
@@ -180,4 +130,32 @@ function mp4:step()
     end
 end
 
+-- R0-R7, режимы и IRQ: 15 байт
+function mp4:saveState()
+    local r = self.regs
+    return lib.packState(r[1], r[2], r[3], r[4], r[5], r[6], r[7], r[8],
+                         self.bankSelect, self.modePRG, self.modeCHR,
+                         self.irqLatch, self.irqCounter, self.irqReload,
+                         self.irqEnabled)
+end
+
+function mp4:loadState(data)
+    local v = {lib.unpackState(data, 15)}
+    if v[1] == nil then return end
+
+    for i = 1, 8 do
+        self.regs[i] = v[i]
+    end
+    self.bankSelect = v[9]
+    self.modePRG = v[10] ~= 0
+    self.modeCHR = v[11] ~= 0
+
+    self.irqLatch = v[12]
+    self.irqCounter = v[13]
+    self.irqReload = v[14] ~= 0
+    self.irqEnabled = v[15] ~= 0
+
+    updateBanks(self)
+end
+
 return mp4
\ No newline at end of file
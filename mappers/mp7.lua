@@ -3,6 +3,11 @@ local lib = require("lib")
 
 local mp7 = {}
 
+local function updateBanks(self)
+    local bankOffset = lib.maskBank(self.prgBank, self.prgBankCount) * 0x8000
+    lib.mapPRG(0, bankOffset, 4)
+end
+
 function mp7:init()
     self.prgBank = 0
     self.prgBankCount = prgSize / 0x8000
@@ -11,12 +16,9 @@ function mp7:init()
     if self.chrRAM then
         lib.resizeCHR(0x2000)
     end
-end
 
-function mp7:readPRGAddr(addr)
-    addr = addr - 0x8000
-    local bankOffset = lib.maskBank(self.prgBank, self.prgBankCount) * 0x8000
-    return (bankOffset + addr)
+    lib.mapCHR(0, 0x0000, 8)
+    updateBanks(self)
 end
 
 function mp7:writePRGAddr(addr, value)
@@ -32,18 +34,21 @@ function mp7:writePRGAddr(addr, value)
         lib.setMirror(lib.MIRROR_SINGLE_SCREEN_B)
     end
 
+    updateBanks(self)
     return nil
 end
 
-function mp7:readCHRAddr(addr)
-    return lib.bit_and(addr, 0x1FFF)
+-- Mirroring хранится в снимке отдельно от регистров
+function mp7:saveState()
+    return lib.packState(self.prgBank)
 end
 
-function mp7:writeCHRAddr(addr, value)
-    if self.chrRAM then
-        return lib.bit_and(addr, 0x1FFF)
-    end
-    return nil
+function mp7:loadState(data)
+    local prgBank = lib.unpackState(data, 1)
+    if prgBank == nil then return end
+
+    self.prgBank = prgBank
+    updateBanks(self)
 end
 
-return mp7
+return mp7
\ No newline at end of file
@@ -3,6 +3,22 @@ local lib = require("lib")
 
 local mp9 = {}
 
+-- CHR переключается защёлками при чтении, поэтому через таблицу
+-- отображается только PRG, а CHR остаётся на readCHRAddr/writeCHRAddr
+local function updatePRG(self)
+    lib.mapPRG(0, lib.maskBank(self.prgBank, self.prgBankCount) * 0x2000)
+
+    local fixedBase = self.prgBankCount - 3
+    if fixedBase < 0 then
+        fixedBase = 0
+    end
+
+    for region = 1, 3 do
+        local bank = lib.maskBank(fixedBase + (region - 1), self.prgBankCount)
+        lib.mapPRG(region, bank * 0x2000)
+    end
+end
+
 function mp9:init()
     self.prgBankCount = prgSize / 0x2000
     self.chrBankCount = chrSize / 0x1000
@@ -22,33 +38,15 @@ function mp9:init()
 
     self.latch0 = 0xFD
     self.latch1 = 0xFD
-end
-
-function mp9:readPRGAddr(addr)
-    addr = addr - 0x8000
 
-    local bank
-    local offset = lib.bit_and(addr, 0x1FFF)
-    local region = lib.bit_rshift(addr, 13) -- 0..3 для 8КБ
-
-    if region == 0 then
-        bank = lib.maskBank(self.prgBank, self.prgBankCount)
-    else
-        local fixedBase = self.prgBankCount - 3
-        if fixedBase < 0 then
-            fixedBase = 0
-        end
-        bank = fixedBase + (region - 1)
-        bank = lib.maskBank(bank, self.prgBankCount)
-    end
-
-    return bank * 0x2000 + offset
+    updatePRG(self)
 end
 
 function mp9:writePRGAddr(addr, value)
     if addr >= 0xA000 and addr <= 0xAFFF then
         -- CHR $8000-$9FFF
         self.prgBank = lib.bit_and(value, 0x0F)
+        updatePRG(self)
     elseif addr >= 0xB000 and addr <= 0xBFFF then
         -- CHR $0000-$0FFF при latch0 == $FD
         self.chrFD0 = lib.bit_and(value, 0x1F)
@@ -115,4 +113,26 @@ function mp9:writeCHRAddr(addr, value)
     return self:readCHRAddr(addr)
 end
 
+-- CHR считается по защёлкам при каждом чтении, в таблице только PRG
+function mp9:saveState()
+    return lib.packState(self.prgBank, self.chrFD0, self.chrFE0,
+                         self.chrFD1, self.chrFE1, self.latch0, self.latch1)
+end
+
+function mp9:loadState(data)
+    local prgBank, chrFD0, chrFE0, chrFD1, chrFE1, latch0, latch1 =
+        lib.unpackState(data, 7)
+    if prgBank == nil then return end
+
+    self.prgBank = prgBank
+    self.chrFD0 = chrFD0
+    self.chrFE0 = chrFE0
+    self.chrFD1 = chrFD1
+    self.chrFE1 = chrFE1
+    self.latch0 = latch0
+    self.latch1 = latch1
+
+    updatePRG(self)
+end
+
 return mp9
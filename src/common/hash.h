@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstring>
+
+#include "common/types.h"
+
+namespace Common::Hash {
+
+/* XXH64 (спецификация xxHash): ~10 ГБ/с на одном ядре, одинаковый
+ * результат на всех платформах. seed позволяет хэшировать по частям:
+ * xxh64(b, nb, xxh64(a, na)) */
+namespace Detail {
+inline constexpr u64 P1 = 0x9E3779B185EBCA87ull;
+inline constexpr u64 P2 = 0xC2B2AE3D27D4EB4Full;
+inline constexpr u64 P3 = 0x165667B19E3779F9ull;
+inline constexpr u64 P4 = 0x85EBCA77C2B2AE63ull;
+inline constexpr u64 P5 = 0x27D4EB2F165667C5ull;
+
+inline u64 rotl(u64 x, u32 r) { return (x << r) | (x >> (64 - r)); }
+
+inline u64 read64(const u8 *p) {
+    u64 v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+inline u32 read32(const u8 *p) {
+    u32 v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+inline u64 round(u64 acc, u64 input) {
+    acc += input * P2;
+    acc = rotl(acc, 31);
+    return acc * P1;
+}
+
+inline u64 merge(u64 acc, u64 val) {
+    acc ^= round(0, val);
+    return acc * P1 + P4;
+}
+} /* namespace Detail */
+
+inline u64 xxh64(const void *data, sz size, u64 seed = 0) {
+    using namespace Detail;
+
+    const u8 *p = static_cast<const u8 *>(data);
+    const u8 *const end = p + size;
+    u64 h;
+
+    if (size >= 32) {
+        u64 v1 = seed + P1 + P2;
+        u64 v2 = seed + P2;
+        u64 v3 = seed;
+        u64 v4 = seed - P1;
+
+        const u8 *const limit = end - 32;
+        do {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge(h, v1);
+        h = merge(h, v2);
+        h = merge(h, v3);
+        h = merge(h, v4);
+    } else {
+        h = seed + P5;
+    }
+
+    h += static_cast<u64>(size);
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * P1 + P4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<u64>(read32(p)) * P1;
+        h = rotl(h, 23) * P2 + P3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= (*p) * P5;
+        h = rotl(h, 11) * P1;
+    }
+
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+} /* namespace Common::Hash */
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/types.h"
+
+namespace Common::Thread {
+
+/* Пул потоков с кражей задач, без Qt (годится для headless и ядра).
+ * У каждого рабочего своя очередь: задача с affinity K всегда кладётся в
+ * очередь K % size(), так что "консоль K" обычно исполняется одним и тем
+ * же потоком и её состояние остаётся в его кэше. Свободный поток сначала
+ * берёт свежую задачу из своей очереди, потом крадёт самую старую у
+ * соседей. Для каждой задачи меряется ожидание в очереди и время работы.
+ */
+class WorkPool {
+public:
+    using Task = std::function<void()>;
+    using clock = std::chrono::steady_clock;
+
+    static inline constexpr u32 ANY = 0xFFFFFFFFu;
+
+    struct TaskStats {
+        u64 id{0};
+        u32 worker{0};  /* кто исполнил */
+        bool stolen{false};
+        f64 waitSec{0}; /* от submit() до начала */
+        f64 runSec{0};
+    };
+
+public:
+    explicit WorkPool(u32 threads = 0) {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        queues.reserve(threads);
+        for (u32 i = 0; i < threads; ++i)
+            queues.push_back(std::make_unique<Queue>());
+
+        workers.reserve(threads);
+        for (u32 i = 0; i < threads; ++i)
+            workers.emplace_back([this, i]() { run(i); });
+    }
+
+    ~WorkPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for (auto &t : workers)
+            t.join();
+    }
+
+    WorkPool(const WorkPool &) = delete;
+    auto operator=(const WorkPool &) -> WorkPool & = delete;
+
+    u32 size() const { return static_cast<u32>(queues.size()); }
+
+    /* affinity - номер "владельца" задачи (например, индекс консоли) */
+    auto submit(Task fn, u32 affinity = ANY) -> u64 {
+        const u64 id = nextId.fetch_add(1, std::memory_order_relaxed);
+        const u32 home = (affinity == ANY)
+                             ? static_cast<u32>(id % size())
+                             : static_cast<u32>(affinity % size());
+
+        /* pending растёт раньше, чем задачу можно взять: иначе она могла
+         * бы завершиться до учёта */
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++pending;
+        }
+
+        {
+            Queue &q = *queues[home];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back({std::move(fn), id, home, clock::now()});
+        }
+        wake.notify_all();
+        return id;
+    }
+
+    /* Дождаться всех задач; первая ошибка пробрасывается сюда */
+    void wait() {
+        std::exception_ptr failure;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            idle.wait(lock, [this]() { return pending == 0; });
+            failure = std::exchange(error, nullptr);
+        }
+
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+
+    /* Статистика задач, завершившихся с прошлого вызова */
+    auto takeStats() -> std::vector<TaskStats> {
+        std::vector<TaskStats> out;
+        for (auto &q : queues) {
+            std::lock_guard<std::mutex> lock(q->mutex);
+            out.insert(out.end(), q->done.begin(), q->done.end());
+            q->done.clear();
+        }
+        return out;
+    }
+
+private:
+    struct Item {
+        Task fn;
+        u64 id;
+        u32 home;
+        clock::time_point queued;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Item> tasks;
+        std::vector<TaskStats> done;
+    };
+
+    /* Своя очередь - с конца (самая свежая), чужая - с начала */
+    bool take(u32 self, Item &out) {
+        {
+            Queue &q = *queues[self];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.tasks.empty()) {
+                out = std::move(q.tasks.back());
+                q.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (u32 i = 1; i < size(); ++i) {
+            Queue &q = *queues[(self + i) % size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.tasks.empty()) {
+                out = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void run(u32 self) {
+        for (;;) {
+            Item item;
+            if (!take(self, item)) {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (stopping)
+                    return;
+
+                /* Задачи могли появиться между take() и захватом mutex:
+                 * pending считает и ещё не взятые */
+                if (pending <= running)
+                    wake.wait(lock);
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++running;
+            }
+
+            TaskStats stats;
+            stats.id = item.id;
+            stats.worker = self;
+            stats.stolen = item.home != self;
+
+            const auto start = clock::now();
+            stats.waitSec =
+                std::chrono::duration<f64>(start - item.queued).count();
+
+            std::exception_ptr failure;
+            try {
+                item.fn();
+            } catch (...) {
+                failure = std::current_exception();
+            }
+            stats.runSec =
+                std::chrono::duration<f64>(clock::now() - start).count();
+
+            {
+                Queue &q = *queues[self];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                q.done.push_back(stats);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (failure && !error)
+                    error = failure;
+                --running;
+                if (--pending == 0)
+                    idle.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<u64> nextId{0};
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    sz pending{0}; /* поставлены, но не завершены */
+    sz running{0}; /* исполняются прямо сейчас */
+    bool stopping{false};
+    std::exception_ptr error;
+};
+
+} /* namespace Common::Thread */
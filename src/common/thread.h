@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <exception>
 #include <functional>
 #include <memory>
@@ -11,6 +14,8 @@
 #include <QThread>
 #include <QWaitCondition>
 
+#include "common/types.h"
+
 namespace Common::Thread {
 
 class FnThread : public QThread {
@@ -140,6 +145,92 @@ private:
     std::optional<T> val_;
 };
 
+/* Тройной буфер без блокировок: один поток пишет, другой читает.
+ * Производитель заполняет back() и вызывает publish(), потребитель
+ * забирает последний опубликованный буфер через tryTake(). Все три
+ * буфера выделены заранее, промежуточные кадры просто перезаписываются.
+ */
+template <typename T> class TripleBuffer {
+public:
+    /* Поток-производитель */
+    auto back() -> T & { return buf_[back_]; }
+
+    void publish() {
+        const u8 prev = mid_.exchange(static_cast<u8>(back_ | FRESH),
+                                      std::memory_order_acq_rel);
+        back_ = prev & INDEX;
+    }
+
+    /* Поток-потребитель: nullptr, если нового буфера нет. Указатель
+     * действителен до следующего tryTake() */
+    auto tryTake() -> const T * {
+        if ((mid_.load(std::memory_order_relaxed) & FRESH) == 0)
+            return nullptr;
+
+        const u8 prev = mid_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & INDEX;
+        return &buf_[front_];
+    }
+
+private:
+    static inline constexpr u8 INDEX = 0x03;
+    static inline constexpr u8 FRESH = 0x04;
+
+    std::array<T, 3> buf_{};
+    u8 back_{0};
+    u8 front_{1};
+    std::atomic<u8> mid_{2};
+};
+
+/* Кольцевой буфер без блокировок для одного писателя и одного читателя */
+template <typename T, sz CAPACITY> class SpscRing {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    /* Записать все count элементов или ничего, если не хватает места
+     * (так блок не разрывается, например, пара L/R сэмплов) */
+    auto tryPush(const T *data, sz count) -> bool {
+        const sz head = head_.load(std::memory_order_relaxed);
+        const sz tail = tail_.load(std::memory_order_acquire);
+        if (count > CAPACITY - (head - tail))
+            return false;
+
+        for (sz i = 0; i < count; ++i)
+            buf_[(head + i) & MASK] = data[i];
+
+        head_.store(head + count, std::memory_order_release);
+        return true;
+    }
+
+    /* Прочитать до count элементов, возвращает сколько прочитано */
+    auto pop(T *out, sz count) -> sz {
+        const sz tail = tail_.load(std::memory_order_relaxed);
+        const sz head = head_.load(std::memory_order_acquire);
+        const sz n = std::min(count, head - tail);
+
+        for (sz i = 0; i < n; ++i)
+            out[i] = buf_[(tail + i) & MASK];
+
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    auto size() const -> sz {
+        return head_.load(std::memory_order_acquire) -
+               tail_.load(std::memory_order_acquire);
+    }
+
+    static constexpr auto capacity() -> sz { return CAPACITY; }
+
+private:
+    static inline constexpr sz MASK = CAPACITY - 1;
+
+    std::array<T, CAPACITY> buf_{};
+    alignas(64) std::atomic<sz> head_{0};
+    alignas(64) std::atomic<sz> tail_{0};
+};
+
 template <typename InputT, typename OutputT> class LatestTaskWorker {
 public:
     using ProcessFn = std::function<OutputT(InputT &&)>;
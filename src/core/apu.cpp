@@ -6,6 +6,7 @@ void Core::APU::powerUp() {
     state.noise.timer = NOISE_TABLE[0];
     state.noise.shiftReg = 1;
     samples.clear();
+    resetBlip();
 }
 
 void Core::APU::reset() {
@@ -14,10 +15,22 @@ void Core::APU::reset() {
     state.noise.shiftReg = 1;
 
     samples.clear();
+    resetBlip();
+}
+
+void Core::APU::endFrame() {
+    if (muted)
+        return;
+
+    blip.endFrame(blipTime);
+    blipTime = 0;
+    blip.readSamples(samples);
 }
 
 /* Запись в регистры Core::APU (0x4000-0x4017) */
 void Core::APU::writeReg(u16 addr, u8 value) {
+    outDirty = true;
+
     switch (addr) {
     /* Pulse 1 */
     case 0x4000:
@@ -265,15 +278,44 @@ void Core::APU::step(u32 cpuCycles) {
         tickTriangleTimer();
         tickDmc();
 
-        /* Накопление и генерация аудиосэмплов */
-        for (state.sampleAcc += cyclesPerSample; state.sampleAcc >= 1.0;
-             state.sampleAcc -= 1.0)
-            samples.push_back(mixSample());
+        /* Дельта микса только при смене выхода каналов */
+        if (outDirty && !muted) {
+            outDirty = false;
+            if (const u32 out = packOutputs(); out != lastOut) {
+                const f32 amp = mixSample(out);
+                blip.addDelta(blipTime, amp - lastAmp);
+                lastOut = out;
+                lastAmp = amp;
+            }
+        }
+
+        if (!muted && ++blipTime >= BLIP_FRAME_CYCLES)
+            endFrame();
 
         state.oddCycle = !state.oddCycle;
     }
 }
 
+u32 Core::APU::cyclesUntilEvent() const {
+    /* Без IRQ APU догоняется только по событиям PPU (раз в кадр) */
+    u32 cycles = 0xFFFFFFFFu;
+
+    /* Отложенный сброс frame counter меняет расписание */
+    if (state.frameCntDelay > 0)
+        return state.frameCntDelay;
+
+    /* frameCycle растёт раз в два CPU-цикла */
+    if (!state.frameCntMode5 && !state.irqInhibit &&
+        state.frameCycle < FRAME_IRQ_CYCLE)
+        cycles = (FRAME_IRQ_CYCLE - state.frameCycle) * 2 - 1;
+
+    /* DMC IRQ ставится при выборке байта, не раньше следующего тика */
+    if (state.dmc.enabled && state.dmc.active && state.dmc.irqEnabled)
+        cycles = std::min<u32>(cycles, state.dmc.timer + 1u);
+
+    return std::max<u32>(cycles, 1);
+}
+
 /* Ход frame counter (4-step / 5-step) */
 void Core::APU::tickFrameCounter() {
     switch (state.frameCycle) {
@@ -299,7 +341,7 @@ void Core::APU::tickFrameCounter() {
             state.frameCycle = 0;
         }
     } else {
-        if (state.frameCycle == 14914) {
+        if (state.frameCycle == FRAME_IRQ_CYCLE) {
             quarterFrame();
             state.delayHalfFrame = true;
             if (!state.irqInhibit)
@@ -311,6 +353,7 @@ void Core::APU::tickFrameCounter() {
 
 /* Quarter-frame: envelope + linear counter */
 void Core::APU::quarterFrame() {
+    outDirty = true;
     clockEnvelope(state.pulse1.lengthHalt, state.pulse1.volPeriod,
                   state.pulse1.envelStart, state.pulse1.envelDiv,
                   state.pulse1.envelDecay);
@@ -334,6 +377,7 @@ void Core::APU::quarterFrame() {
 
 /* Half-frame: length counters + sweep */
 void Core::APU::halfFrame() {
+    outDirty = true;
     clockLengthCounter(state.pulse1.lengthHalt, state.pulse1.lenCnt);
     clockLengthCounter(state.pulse2.lengthHalt, state.pulse2.lenCnt);
     clockLengthCounter(state.triangle.ctrlFlag, state.triangle.lenCnt);
@@ -398,6 +442,7 @@ void Core::APU::tickPulseTimer(Pulse &pulse) {
     if (pulse.timer == 0) {
         pulse.timer = pulse.timerPeriod;
         pulse.seqPos = static_cast<u8>((pulse.seqPos + 1) & 0x07);
+        outDirty = true;
     } else
         --pulse.timer;
 }
@@ -406,9 +451,11 @@ void Core::APU::tickPulseTimer(Pulse &pulse) {
 void Core::APU::tickTriangleTimer() {
     if (state.triangle.timer == 0) {
         state.triangle.timer = state.triangle.timerPeriod;
-        if (state.triangle.lenCnt > 0 && state.triangle.linearCnt > 0)
+        if (state.triangle.lenCnt > 0 && state.triangle.linearCnt > 0) {
             state.triangle.seqPos =
                 static_cast<u8>((state.triangle.seqPos + 1) & 0x1F);
+            outDirty = true;
+        }
     } else
         --state.triangle.timer;
 }
@@ -425,6 +472,7 @@ void Core::APU::tickNoiseTimer() {
 
         state.noise.shiftReg >>= 1;
         state.noise.shiftReg |= static_cast<u16>(fb << 14);
+        outDirty = true;
     } else
         --state.noise.timer;
 }
@@ -441,6 +489,7 @@ void Core::APU::tickDmc() {
 
     state.dmc.timer =
         static_cast<u16>(DMC_TABLE[state.dmc.rateIndex & 0x0F] - 1);
+    outDirty = true;
 
     if (state.dmc.bitsRemain == 0) {
         if (state.dmc.bufferEmpty) {
@@ -511,19 +560,3 @@ u8 Core::APU::pulseOut(const Pulse &pulse, bool secondChannel) const {
 
     return pulse.constVol ? pulse.volPeriod : pulse.envelDecay;
 }
-
-/* Нелинейный миксер NES Core::APU (Pulse + TND) */
-f32 Core::APU::mixSample() const {
-    const f64 p1 = static_cast<f64>(pulseOut(state.pulse1, false));
-    const f64 p2 = static_cast<f64>(pulseOut(state.pulse2, true));
-    const f64 t = static_cast<f64>(triangleOut());
-    const f64 n = static_cast<f64>(noiseOut());
-    const f64 d = static_cast<f64>(dmcOut());
-
-    const f64 pulse =
-        (p1 + p2 == 0.0) ? 0.0 : 95.88 / ((8128.0 / (p1 + p2)) + 100.0);
-    const f64 tndIn = (t / 8227.0) + (n / 12241.0) + (d / 22638.0);
-    const f64 tnd = (tndIn == 0.0) ? 0.0 : 159.79 / ((1.0 / tndIn) + 100.0);
-
-    return static_cast<f32>(std::clamp(pulse + tnd, 0.0, 1.0));
-}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "common/types.h"
 
+#include "core/blip.h"
+
 namespace Core {
 class APU {
 public:
@@ -21,6 +24,12 @@ public:
     static inline constexpr f64 PAL_CYCLES = AUDIO_SAMPLE_RATE / PAL_CPU_HZ;
     static inline constexpr f64 DENDY_CYCLES = AUDIO_SAMPLE_RATE / DENDY_CPU_HZ;
 
+    /* Не дольше стольких CPU-циклов дельты копятся без выдачи сэмплов */
+    static inline constexpr u32 BLIP_FRAME_CYCLES = 32768;
+
+    /* Шаг frame counter (4-step), на котором ставится frame IRQ */
+    static inline constexpr u32 FRAME_IRQ_CYCLE = 14914;
+
     /* Таблица длины (length counter) для Pulse/Triangle/Noise */
     static inline constexpr u8 LENGTH_TABLE[32] = {
         10, 254, 20, 2,  40, 4,  80, 6,  160, 8,  60, 10, 14, 12, 26, 14,
@@ -54,7 +63,9 @@ public:
     };
 
 public:
-    explicit APU() = default;
+    explicit APU() : blip(NTSC_CYCLES, BLIP_FRAME_CYCLES) {
+        samples.reserve(BLIP_FRAME_CYCLES);
+    }
     ~APU() = default;
 
     void powerUp();
@@ -65,6 +76,12 @@ public:
 
     void step(u32 cpuCycles);
 
+    /* Перевести накопленные дельты в сэмплы (samples) */
+    void endFrame();
+
+    /* Сколько CPU-циклов можно выполнить пачкой до возможного IRQ */
+    u32 cyclesUntilEvent() const;
+
 public:
     /* Pulse канал */
     struct Pulse {
@@ -163,10 +180,20 @@ public:
     bool debug{false};
 
 public:
-    /* Региональный коэффициент семплирования */
-    f64 cyclesPerSample{NTSC_CYCLES};
+    /* Региональный коэффициент семплирования (сэмплов на CPU-цикл) */
+    void setCyclesPerSample(f64 ratio) {
+        endFrame();
+        cyclesPerSample = ratio;
+        blip.setRatio(ratio);
+    }
+
     std::vector<f32> samples{};
 
+    /* Без звука: каналы работают как обычно, но blip не трогается и
+     * samples не пополняется (спекулятивные кадры run-ahead) */
+    void setMuted(bool m) { muted = m; }
+    bool isMuted() const { return muted; }
+
 public:
     /* Полное состояние APU для save/load state */
     struct State {
@@ -189,7 +216,8 @@ public:
         bool pendHalfFrame{false};
         bool delayHalfFrame{false};
 
-        /* Накопитель до следующего аудиосэмпла */
+        /* Не используется с band-limited синтезом, оставлен ради
+         * формата save state */
         f64 sampleAcc{0.0};
     };
 
@@ -197,11 +225,37 @@ public:
     void loadState(const State &s) {
         state = s;
         samples.clear();
+        resetBlip();
+    }
+
+    /* Откат состояния без сброса blip: выход продолжается с того места,
+     * где был до спекулятивных кадров, без щелчка */
+    void restoreState(const State &s) {
+        state = s;
+        outDirty = true;
     }
 
 private:
     State state{};
 
+    /* Band-limited выход: дельты микса пишутся только при смене
+     * выходов каналов, сэмплы получаются в endFrame() */
+    f64 cyclesPerSample{NTSC_CYCLES};
+    BlipBuffer blip;
+    u32 blipTime{0};     /* CPU-циклов с начала текущего кадра blip */
+    u32 lastOut{0};      /* выходы каналов, упакованные packOutputs() */
+    f32 lastAmp{0.0f};   /* микс для lastOut */
+    bool outDirty{true}; /* выход какого-то канала мог измениться */
+    bool muted{false};
+
+    void resetBlip() {
+        blip.clear();
+        blipTime = 0;
+        outDirty = true;
+        lastOut = packOutputs();
+        lastAmp = mixSample(lastOut);
+    }
+
 private:
     /* Такты блока frame counter */
     void tickFrameCounter();
@@ -261,7 +315,44 @@ private:
     }
     u8 dmcOut() const { return state.dmc.outLevel; }
 
-    f32 mixSample() const;
+    /* pulse1 | pulse2 << 4 | triangle << 8 | noise << 12 | dmc << 16 */
+    u32 packOutputs() const {
+        return static_cast<u32>(pulseOut(state.pulse1, false)) |
+               static_cast<u32>(pulseOut(state.pulse2, true)) << 4 |
+               static_cast<u32>(triangleOut()) << 8 |
+               static_cast<u32>(noiseOut()) << 12 |
+               static_cast<u32>(dmcOut()) << 16;
+    }
+
+    /* Нелинейный миксер по таблицам (nesdev: pulse_table/tnd_table) */
+    static constexpr auto makePulseMix() -> std::array<f32, 31> {
+        std::array<f32, 31> t{};
+        for (sz i = 1; i < t.size(); ++i)
+            t[i] = static_cast<f32>(95.52 / (8128.0 / static_cast<f64>(i) +
+                                             100.0));
+        return t;
+    }
+    static constexpr auto makeTndMix() -> std::array<f32, 203> {
+        std::array<f32, 203> t{};
+        for (sz i = 1; i < t.size(); ++i)
+            t[i] = static_cast<f32>(163.67 / (24329.0 / static_cast<f64>(i) +
+                                              100.0));
+        return t;
+    }
+    static const std::array<f32, 31> PULSE_MIX;
+    static const std::array<f32, 203> TND_MIX;
+
+    static f32 mixSample(u32 out) {
+        const u32 p1 = out & 0x0F;
+        const u32 p2 = (out >> 4) & 0x0F;
+        const u32 t = (out >> 8) & 0x0F;
+        const u32 n = (out >> 12) & 0x0F;
+        const u32 d = (out >> 16) & 0x7F;
+        return PULSE_MIX[p1 + p2] + TND_MIX[3 * t + 2 * n + d];
+    }
 };
 
+inline constexpr std::array<f32, 31> APU::PULSE_MIX = APU::makePulseMix();
+inline constexpr std::array<f32, 203> APU::TND_MIX = APU::makeTndMix();
+
 } /* namespace Core */
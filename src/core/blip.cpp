@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cmath>
+
+#include "core/blip.h"
+
+const Core::BlipBuffer::Kernel Core::BlipBuffer::KERNEL =
+    Core::BlipBuffer::makeKernel();
+
+Core::BlipBuffer::BlipBuffer(f64 samplesPerClock, u32 maxFrameClocks)
+    : maxClocks(maxFrameClocks) {
+    setRatio(samplesPerClock);
+}
+
+void Core::BlipBuffer::setRatio(f64 samplesPerClock) {
+    factor = static_cast<u64>(
+        std::llround(samplesPerClock * static_cast<f64>(u64{1} << FRAC_BITS)));
+
+    /* Самый длинный кадр плюс хвост ядра последней ступеньки */
+    const sz frameSamples =
+        static_cast<sz>(std::ceil(samplesPerClock * maxClocks)) + 1;
+    buf.assign(frameSamples + 2 * WIDTH, 0.0f);
+
+    clear();
+}
+
+void Core::BlipBuffer::clear() {
+    std::fill(buf.begin(), buf.end(), 0.0f);
+    offset = 0;
+    integrator = 0.0f;
+}
+
+void Core::BlipBuffer::endFrame(u32 clocks) {
+    offset += clocks * factor;
+}
+
+void Core::BlipBuffer::readSamples(std::vector<f32> &out) {
+    const sz count = std::min(samplesAvail(), buf.size() - WIDTH);
+
+    for (sz i = 0; i < count; ++i) {
+        integrator += buf[i];
+        out.push_back(integrator);
+        integrator -= integrator * HIGH_PASS;
+    }
+
+    /* Хвосты ступенек уходят в начало буфера */
+    std::copy(buf.begin() + count, buf.begin() + count + WIDTH, buf.begin());
+    std::fill(buf.begin() + WIDTH, buf.begin() + count + WIDTH, 0.0f);
+
+    offset -= static_cast<u64>(count) << FRAC_BITS;
+}
+
+/* Ступенька = интеграл windowed-sinc; в таблице лежит сама sinc-дельта,
+ * разложенная по WIDTH сэмплам для каждой дробной фазы */
+auto Core::BlipBuffer::makeKernel() -> Kernel {
+    constexpr f64 PI = 3.14159265358979323846;
+    constexpr f64 CUTOFF = 0.90; /* доля от частоты Найквиста */
+    constexpr f64 HALF = static_cast<f64>(WIDTH) / 2.0;
+
+    Kernel k{};
+    for (sz p = 0; p < PHASES; ++p) {
+        const f64 frac = static_cast<f64>(p) / static_cast<f64>(PHASES);
+
+        f64 sum = 0.0;
+        std::array<f64, WIDTH> row{};
+        for (sz i = 0; i < WIDTH; ++i) {
+            /* Расстояние от ступеньки до центра сэмпла i */
+            const f64 t = static_cast<f64>(i) - (HALF - 1.0) - frac;
+            const f64 x = PI * CUTOFF * t;
+            const f64 sinc = (std::abs(x) < 1e-9) ? 1.0 : std::sin(x) / x;
+
+            /* Окно Блэкмана на [-HALF, HALF] */
+            const f64 w = (t + HALF) / (2.0 * HALF);
+            const f64 window = 0.42 - 0.5 * std::cos(2.0 * PI * w) +
+                               0.08 * std::cos(4.0 * PI * w);
+
+            row[i] = sinc * window;
+            sum += row[i];
+        }
+
+        /* Сумма строки = 1: после интегрирования ступенька равна delta */
+        for (sz i = 0; i < WIDTH; ++i)
+            k[p][i] = static_cast<f32>(row[i] / sum);
+    }
+    return k;
+}
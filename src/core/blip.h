@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "common/types.h"
+
+namespace Core {
+/* Band-limited синтез ступенек (в духе blip_buf).
+ * Источник сообщает только изменения амплитуды (addDelta) в тактах от
+ * начала кадра; каждое изменение кладётся в буфер как ступенька,
+ * сглаженная windowed-sinc ядром. endFrame() закрывает кадр, после чего
+ * readSamples() интегрирует дельты в готовые сэмплы.
+ */
+class BlipBuffer {
+public:
+    /* Ширина ядра в сэмплах и число фаз внутри одного сэмпла */
+    static inline constexpr sz WIDTH = 16;
+    static inline constexpr sz PHASES = 64;
+
+public:
+    explicit BlipBuffer(f64 samplesPerClock, u32 maxFrameClocks);
+    ~BlipBuffer() = default;
+
+    /* Сэмплов на такт источника; буфер переразмечается под новый кадр */
+    void setRatio(f64 samplesPerClock);
+    void clear();
+
+    inline void addDelta(u32 time, f32 delta) {
+        const u64 fixed = time * factor + offset;
+        const sz pos = static_cast<sz>(fixed >> FRAC_BITS);
+        if (pos + WIDTH > buf.size())
+            return;
+
+        const auto &k =
+            KERNEL[(fixed >> (FRAC_BITS - PHASE_BITS)) & (PHASES - 1)];
+        f32 *out = &buf[pos];
+        for (sz i = 0; i < WIDTH; ++i)
+            out[i] += delta * k[i];
+    }
+
+    /* Кадр длиной clocks тактов завершён: его сэмплы готовы к чтению */
+    void endFrame(u32 clocks);
+
+    sz samplesAvail() const { return static_cast<sz>(offset >> FRAC_BITS); }
+
+    /* Дописать все готовые сэмплы в out */
+    void readSamples(std::vector<f32> &out);
+
+private:
+    static inline constexpr u32 FRAC_BITS = 32;
+    static inline constexpr u32 PHASE_BITS = 6;
+    static_assert((sz{1} << PHASE_BITS) == PHASES);
+
+    /* Срез DC (~14 Гц на 44.1 кГц), как bass_shift = 9 в blip_buf */
+    static inline constexpr f32 HIGH_PASS = 1.0f / 512.0f;
+
+    using Kernel = std::array<std::array<f32, WIDTH>, PHASES>;
+    static auto makeKernel() -> Kernel;
+    static const Kernel KERNEL;
+
+    u64 factor{0}; /* сэмплов на такт, 32.32 */
+    u64 offset{0}; /* позиция конца кадра в буфере, 32.32 */
+    u32 maxClocks{0};
+    f32 integrator{0.0f};
+    std::vector<f32> buf;
+};
+
+} /* namespace Core */
@@ -17,7 +17,7 @@ void Core::Cartridge::loadNES(const std::filesystem::path &path) {
         rom.seekg(512, std::ios::cur);
 
     mapperNumber = fmt.mapper();
-    mirror = fmt.mirroring();
+    setMirror(fmt.mirroring());
 
     /* Чтение PRG ROM */
     PRG_ROM.resize(static_cast<size_t>(fmt.prg_banks()) * 0x4000);
@@ -38,4 +38,60 @@ void Core::Cartridge::loadNES(const std::filesystem::path &path) {
         chrRam = true;
         CHR_ROM.clear();
     }
+    invalidateCHR();
+    storageChanged();
+}
+
+void Core::Cartridge::loadImage(const Cartridge &other) {
+    fmt = other.fmt;
+    mapperNumber = fmt.mapper();
+    setMirror(fmt.mirroring());
+
+    PRG_ROM = other.PRG_ROM;
+    chrRam = fmt.chr_is_ram();
+    if (chrRam)
+        CHR_ROM.clear();
+    else
+        CHR_ROM = other.CHR_ROM;
+    invalidateCHR();
+    storageChanged();
+}
+
+void Core::Cartridge::invalidateCHR() {
+    const sz tiles = (CHR_ROM.size() + 15) / 16;
+    chrRows.assign(tiles * 8, CHRRow{});
+    chrTileReady.assign(tiles, 0);
+}
+
+void Core::Cartridge::decodeTile(u32 tile) {
+    const sz base = static_cast<sz>(tile) * 16;
+    for (u32 row = 0; row < 8; ++row) {
+        const sz lo = base + row;
+        const sz hi = lo + 8;
+        const u8 low = (lo < CHR_ROM.size()) ? CHR_ROM[lo] : 0;
+        const u8 high = (hi < CHR_ROM.size()) ? CHR_ROM[hi] : 0;
+        chrRows[(tile << 3) | row] = {packRow(low, high), low, high};
+    }
+    chrTileReady[tile] = 1;
+}
+
+void Core::Cartridge::setMirror(u8 mode) {
+    mirror = static_cast<MirrorMode>(mode);
+    ntMap = mirrorPages(mode);
+}
+
+auto Core::Cartridge::mirrorPages(u8 mode) -> std::array<u16, 4> {
+    switch (mode) {
+    case HORIZONTAL:
+        return {0x000, 0x000, 0x400, 0x400};
+    case VERTICAL:
+        return {0x000, 0x400, 0x000, 0x400};
+    case SINGLE_DOWN:
+        return {0x000, 0x000, 0x000, 0x000};
+    case SINGLE_UP:
+        return {0x400, 0x400, 0x400, 0x400};
+    case FOUR:
+    default:
+        return {0x000, 0x400, 0x800, 0xC00};
+    }
 }
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <filesystem>
+#include <functional>
 #include <vector>
 
 #include "common/types.h"
@@ -14,6 +15,10 @@ public:
 
     void loadNES(const std::filesystem::path &path);
 
+    /* ROM уже загруженного картриджа, как после его loadNES(), без
+     * чтения файла (PRG RAM и CHR RAM - пустые) */
+    void loadImage(const Cartridge &other);
+
 public:
     enum MirrorMode : u8 {
         HORIZONTAL = 0,  /* [A,A,B,B] */
@@ -23,6 +28,11 @@ public:
         SINGLE_UP = 4,   /* [B,B,B,B] */
     } mirror{HORIZONTAL};
 
+    /* Смена mirroring только через setMirror(): она же перестраивает
+     * ntMap. Неизвестный режим раскладывается как FOUR */
+    void setMirror(u8 mode);
+    static auto mirrorPages(u8 mode) -> std::array<u16, 4>;
+
     struct NESFormat {
         std::array<u8, 16> raw{};
 
@@ -55,6 +65,92 @@ public:
     u8 mapperNumber{0}; /* Номер маппера (0-255)   */
     bool chrRam{false};
     bool irqFlag{false};
+
+    /* Таблицы банков: смещения в PRG_ROM/CHR_ROM для окон по 8 КБ
+     * ($8000-$FFFF) и по 1 КБ ($0000-$1FFF). Пока маппер не заполнил
+     * таблицу (prgBanked/chrBanked), адрес считается его callback-ом. */
+    std::array<u32, 4> prgMap{};
+    std::array<u32, 8> chrMap{};
+    bool prgBanked{false};
+    bool chrBanked{false};
+
+    /* Nametable-ы: смещения в nametable RAM PPU для окон по 1 КБ
+     * $2000-$2FFF (выборка фона - один индекс вместо разбора mirror) */
+    std::array<u16, 4> ntMap{mirrorPages(HORIZONTAL)};
+
+    /* PRG_ROM/PRG_RAM/CHR_ROM заменены или изменили размер: подписчик
+     * (Memory) пересобирает указатели на них */
+    std::function<void()> onStorageChanged;
+    inline void storageChanged() {
+        if (onStorageChanged)
+            onStorageChanged();
+    }
+
+    /* Окно PRG slot (8 КБ с $8000 + slot * $2000) на смещение offset.
+     * Подписчик (Memory) пересобирает страницы только изменившегося окна;
+     * первое отображение включает таблицу целиком */
+    std::function<void(u8)> onPRGMapped;
+    inline void mapPRG(u8 slot, u32 offset) {
+        slot &= 0x03;
+        if (prgBanked && prgMap[slot] == offset)
+            return;
+
+        prgMap[slot] = offset;
+        if (!prgBanked) {
+            prgBanked = true;
+            storageChanged();
+        } else if (onPRGMapped) {
+            onPRGMapped(slot);
+        }
+    }
+
+public:
+    /* Строка тайла: обе плоскости и 8 пикселей по 2 бита, левый пиксель
+     * в старших битах pixels (как в сдвиговых регистрах PPU) */
+    struct CHRRow {
+        u16 pixels{0};
+        u8 low{0};
+        u8 high{0};
+    };
+
+    static u16 packRow(u8 low, u8 high) {
+        u32 l = low;
+        u32 h = high;
+        l = (l | (l << 4)) & 0x0F0F;
+        l = (l | (l << 2)) & 0x3333;
+        l = (l | (l << 1)) & 0x5555;
+        h = (h | (h << 4)) & 0x0F0F;
+        h = (h | (h << 2)) & 0x3333;
+        h = (h | (h << 1)) & 0x5555;
+        return static_cast<u16>(l | (h << 1));
+    }
+
+    /* Строка тайла по смещению плоскости low в CHR_ROM. Тайлы
+     * декодируются при первом обращении; за пределами CHR_ROM - нули */
+    inline CHRRow chrRow(u32 offset) {
+        const u32 tile = offset >> 4;
+        if (tile >= chrTileReady.size())
+            return {};
+        if (!chrTileReady[tile])
+            decodeTile(tile);
+        return chrRows[(tile << 3) | (offset & 0x07)];
+    }
+
+    /* Сброс кэша строк: весь (CHR_ROM заменён или изменил размер) или
+     * тайла с байтом offset (запись в CHR RAM) */
+    void invalidateCHR();
+    inline void invalidateCHR(u32 offset) {
+        if ((offset >> 4) < chrTileReady.size())
+            chrTileReady[offset >> 4] = 0;
+    }
+
+private:
+    void decodeTile(u32 tile);
+
+    /* Кэш ключуется смещением в CHR_ROM, а не адресом PPU: смена банков
+     * меняет только chrMap, декодированные тайлы остаются верными */
+    std::vector<CHRRow> chrRows;
+    std::vector<u8> chrTileReady;
 };
 
 } /* namespace Core */
\ No newline at end of file
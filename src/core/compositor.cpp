@@ -0,0 +1,191 @@
+#include "core/compositor.h"
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COMPOSE_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define COMPOSE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+constexpr u8 PIXEL = 0x03;
+constexpr u8 INDEX = 0x0F;
+constexpr u8 BEHIND = 0x10;
+constexpr u8 SPRITE0 = 0x20;
+
+/* PPUMASK: левые 8 пикселей фона/спрайтов, фон и спрайты включены */
+inline bool leftBackground(u8 ppumask) { return (ppumask & 0x02) != 0; }
+inline bool leftSprites(u8 ppumask) { return (ppumask & 0x04) != 0; }
+inline bool hitEnabled(u8 ppumask) { return (ppumask & 0x18) == 0x18; }
+
+/* Первый установленный бит маски movemask/сравнения блока */
+inline i32 firstBit(u32 bits) {
+    i32 i = 0;
+    while ((bits & 1u) == 0) {
+        bits >>= 1;
+        ++i;
+    }
+    return i;
+}
+} /* namespace */
+
+auto Core::Compositor::composeScalar(const u8 *bg, const u8 *spr, u8 ppumask,
+                                     u8 *out) -> i32 {
+    const bool hitOn = hitEnabled(ppumask);
+    i32 hit = -1;
+
+    for (sz x = 0; x < WIDTH; ++x) {
+        u8 b = bg[x];
+        u8 s = spr[x];
+        if (x < 8) {
+            if (!leftBackground(ppumask))
+                b = 0;
+            if (!leftSprites(ppumask))
+                s = 0;
+        }
+
+        /* На x = 255 sprite-0 hit не ставится */
+        if (hitOn && hit < 0 && (s & SPRITE0) && x < WIDTH - 1)
+            hit = static_cast<i32>(x);
+
+        const bool bgOpaque = (b & PIXEL) != 0;
+        if ((s & PIXEL) != 0 && (!bgOpaque || !(s & BEHIND)))
+            out[x] = static_cast<u8>(BEHIND | (s & INDEX));
+        else
+            out[x] = bgOpaque ? static_cast<u8>(b & INDEX) : 0;
+    }
+
+    return hit;
+}
+
+#if defined(COMPOSE_SSE2)
+auto Core::Compositor::compose(const u8 *bg, const u8 *spr, u8 ppumask,
+                               u8 *out) -> i32 {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i pixel = _mm_set1_epi8(PIXEL);
+    const __m128i index = _mm_set1_epi8(INDEX);
+    const __m128i behind = _mm_set1_epi8(BEHIND);
+    const __m128i sprite0 = _mm_set1_epi8(SPRITE0);
+
+    /* Маска левого края: младшие 8 байт первого блока */
+    const i32 keepBg = leftBackground(ppumask) ? -1 : 0;
+    const i32 keepSpr = leftSprites(ppumask) ? -1 : 0;
+    const __m128i leftBg = _mm_set_epi32(-1, -1, keepBg, keepBg);
+    const __m128i leftSpr = _mm_set_epi32(-1, -1, keepSpr, keepSpr);
+
+    const bool hitOn = hitEnabled(ppumask);
+    i32 hit = -1;
+
+    for (sz x = 0; x < WIDTH; x += 16) {
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bg + x));
+        __m128i s =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(spr + x));
+        if (x == 0) {
+            b = _mm_and_si128(b, leftBg);
+            s = _mm_and_si128(s, leftSpr);
+        }
+
+        const __m128i bgClear = _mm_cmpeq_epi8(_mm_and_si128(b, pixel), zero);
+        const __m128i sprClear =
+            _mm_cmpeq_epi8(_mm_and_si128(s, pixel), zero);
+        const __m128i inFront =
+            _mm_cmpeq_epi8(_mm_and_si128(s, behind), zero);
+
+        /* Спрайт виден: непрозрачен и (фон прозрачен или спрайт перед) */
+        const __m128i sprWins =
+            _mm_andnot_si128(sprClear, _mm_or_si128(bgClear, inFront));
+        const __m128i bgOut =
+            _mm_andnot_si128(bgClear, _mm_and_si128(b, index));
+        const __m128i sprOut = _mm_or_si128(_mm_and_si128(s, index), behind);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x),
+                         _mm_or_si128(_mm_and_si128(sprWins, sprOut),
+                                      _mm_andnot_si128(sprWins, bgOut)));
+
+        if (hitOn && hit < 0) {
+            u32 bits = static_cast<u32>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_and_si128(s, sprite0), sprite0)));
+            if (x == WIDTH - 16)
+                bits &= 0x7FFFu;
+            if (bits != 0)
+                hit = static_cast<i32>(x) + firstBit(bits);
+        }
+    }
+
+    return hit;
+}
+
+auto Core::Compositor::backend() -> const char * { return "sse2"; }
+#elif defined(COMPOSE_NEON)
+auto Core::Compositor::compose(const u8 *bg, const u8 *spr, u8 ppumask,
+                               u8 *out) -> i32 {
+    const uint8x16_t pixel = vdupq_n_u8(PIXEL);
+    const uint8x16_t index = vdupq_n_u8(INDEX);
+    const uint8x16_t behind = vdupq_n_u8(BEHIND);
+    const uint8x16_t sprite0 = vdupq_n_u8(SPRITE0);
+
+    /* Маска левого края: младшие 8 байт первого блока */
+    const uint8x16_t leftBg = vcombine_u8(
+        vdup_n_u8(leftBackground(ppumask) ? 0xFF : 0x00), vdup_n_u8(0xFF));
+    const uint8x16_t leftSpr = vcombine_u8(
+        vdup_n_u8(leftSprites(ppumask) ? 0xFF : 0x00), vdup_n_u8(0xFF));
+
+    const bool hitOn = hitEnabled(ppumask);
+    i32 hit = -1;
+
+    for (sz x = 0; x < WIDTH; x += 16) {
+        uint8x16_t b = vld1q_u8(bg + x);
+        uint8x16_t s = vld1q_u8(spr + x);
+        if (x == 0) {
+            b = vandq_u8(b, leftBg);
+            s = vandq_u8(s, leftSpr);
+        }
+
+        const uint8x16_t bgOpaque = vtstq_u8(b, pixel);
+        const uint8x16_t sprOpaque = vtstq_u8(s, pixel);
+
+        /* Спрайт виден: непрозрачен и не (фон непрозрачен и спрайт за ним) */
+        const uint8x16_t sprWins =
+            vbicq_u8(sprOpaque, vandq_u8(bgOpaque, vtstq_u8(s, behind)));
+        const uint8x16_t bgOut = vandq_u8(bgOpaque, vandq_u8(b, index));
+        const uint8x16_t sprOut = vorrq_u8(vandq_u8(s, index), behind);
+
+        vst1q_u8(out + x, vbslq_u8(sprWins, sprOut, bgOut));
+
+        if (hitOn && hit < 0 && vmaxvq_u8(vtstq_u8(s, sprite0)) != 0) {
+            const sz end = (x == WIDTH - 16) ? WIDTH - 1 : x + 16;
+            for (sz i = x; i < end; ++i) {
+                if ((spr[i] & SPRITE0) && (i >= 8 || leftSprites(ppumask))) {
+                    hit = static_cast<i32>(i);
+                    break;
+                }
+            }
+        }
+    }
+
+    return hit;
+}
+
+auto Core::Compositor::backend() -> const char * { return "neon"; }
+#else
+auto Core::Compositor::compose(const u8 *bg, const u8 *spr, u8 ppumask,
+                               u8 *out) -> i32 {
+    return composeScalar(bg, spr, ppumask, out);
+}
+
+auto Core::Compositor::backend() -> const char * { return "scalar"; }
+#endif
+
+auto Core::Compositor::sprite0Hit(const u8 *spr, u8 ppumask) -> i32 {
+    if (!hitEnabled(ppumask))
+        return -1;
+
+    const sz first = leftSprites(ppumask) ? 0 : 8;
+    for (sz x = first; x < WIDTH - 1; ++x) {
+        if (spr[x] & SPRITE0)
+            return static_cast<i32>(x);
+    }
+    return -1;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "common/types.h"
+
+namespace Core::Compositor {
+
+/* Сведение видимой строки PPU: фон и спрайты уже разложены по байту на
+ * пиксель, остаётся маска левых 8 пикселей, приоритет и sprite-0 hit.
+ * Строки по 256 байт:
+ *   bg  - биты 0-1 пиксель фона, 2-3 палитра;
+ *   spr - биты 0-1 пиксель переднего спрайта, 2-3 палитра, 4 - спрайт за
+ *         фоном, 5 - здесь непрозрачный пиксель спрайта 0;
+ *   out - индекс palette RAM (0-31), 0 - общий цвет фона.
+ * Векторная версия (SSE2 на x86, NEON на AArch64) сводит по 16 пикселей
+ * и должна совпадать со скалярной до бита (nespp-compose-bench).
+ */
+inline constexpr sz WIDTH = 256;
+
+/* x первого sprite-0 hit в строке или -1 */
+auto compose(const u8 *bg, const u8 *spr, u8 ppumask, u8 *out) -> i32;
+auto composeScalar(const u8 *bg, const u8 *spr, u8 ppumask, u8 *out) -> i32;
+
+/* Только sprite-0 hit: строка не выводится (PPU::skipOutput) */
+auto sprite0Hit(const u8 *spr, u8 ppumask) -> i32;
+
+/* "sse2", "neon" или "scalar" */
+auto backend() -> const char *;
+
+} /* namespace Core::Compositor */
@@ -0,0 +1,317 @@
+#include <stdexcept>
+
+#include "common/hash.h"
+
+#include "core/console.h"
+
+#include "core/savestate.h"
+
+void Core::Console::loadRom(const std::filesystem::path &romPath,
+                            const std::filesystem::path &mapperDir) {
+    unload();
+
+    try {
+        mapper = std::make_unique<Mapper>();
+        mapper->loadNES(romPath);
+        powerUp(mapperDir);
+    } catch (...) {
+        unload();
+        throw;
+    }
+}
+
+void Core::Console::loadRom(const Console &source,
+                            const std::filesystem::path &mapperDir) {
+    if (!source.isLoaded())
+        throw std::runtime_error("[LOAD]: В консоли-источнике нет ROM");
+
+    unload();
+
+    try {
+        mapper = std::make_unique<Mapper>();
+        mapper->loadImage(*source.mapper);
+        powerUp(mapperDir);
+    } catch (...) {
+        unload();
+        throw;
+    }
+}
+
+void Core::Console::powerUp(const std::filesystem::path &mapperDir) {
+    mapper->forceLua = luaMappers;
+    mapper->load(mapperDir);
+
+    ppu = std::make_unique<PPU>(mapper.get());
+
+    apu = std::make_unique<APU>();
+    apu->powerUp();
+
+    mem = std::make_unique<Memory>(mapper.get(), ppu.get(), apu.get());
+    cpu = std::make_unique<CPU>(mem.get());
+
+    attach();
+    applyRegion();
+    cpu->reset();
+}
+
+void Core::Console::unload() {
+    scheduler.detach();
+
+    cpu.reset();
+    mem.reset();
+    apu.reset();
+    ppu.reset();
+    mapper.reset();
+
+    frameCount = 0;
+    instructionCount = 0;
+}
+
+void Core::Console::reset() {
+    scheduler.sync();
+
+    if (cpu)
+        cpu->reset();
+    if (apu)
+        apu->reset();
+
+    setJoy1(0);
+    setJoy2(0);
+
+    scheduler.resetClock();
+}
+
+void Core::Console::setRegion(PPU::Region newRegion) {
+    region = newRegion;
+    applyRegion();
+}
+
+void Core::Console::attach() {
+    mem->scheduler = &scheduler;
+    scheduler.attach(cpu.get(), ppu.get(), apu.get(), mapper.get());
+}
+
+void Core::Console::applyRegion() {
+    scheduler.setRegion(region);
+
+    if (ppu)
+        ppu->setRegion(region);
+
+    if (apu) {
+        apu->setCyclesPerSample((region == PPU::Region::PAL) ? APU::PAL_CYCLES
+                                : (region == PPU::Region::DENDY)
+                                    ? APU::DENDY_CYCLES
+                                    : APU::NTSC_CYCLES);
+    }
+}
+
+void Core::Console::runInstruction() {
+    if (!isLoaded())
+        return;
+
+    scheduler.beginInstruction();
+    cpu->exec();
+    ++instructionCount;
+
+    const u32 cycles = cpu->c.op_cycles;
+    scheduler.endInstruction((cycles != 0) ? cycles : 1);
+}
+
+bool Core::Console::runFrame(bool present) {
+    if (!isLoaded())
+        return false;
+
+    if (present || ppu->skipOutput)
+        return stepFrame();
+
+    ppu->skipOutput = true;
+    bool ok = false;
+    try {
+        ok = stepFrame();
+    } catch (...) {
+        ppu->skipOutput = false;
+        throw;
+    }
+    ppu->skipOutput = false;
+    return ok;
+}
+
+bool Core::Console::stepFrame() {
+    u32 safetyCounter = 0;
+
+    ppu->r.frameReady = false;
+    while (!ppu->r.frameReady) {
+        runInstruction();
+
+        if (++safetyCounter >= MAX_CPU_INSTRUCTIONS_PER_FRAME)
+            return false;
+    }
+
+    /* Звук кадра ресемплируется один раз */
+    apu->endFrame();
+
+    ++frameCount;
+    return true;
+}
+
+bool Core::Console::runFrameMuted(bool present) {
+    if (!isLoaded())
+        return false;
+
+    apu->setMuted(true);
+    bool ok = false;
+    try {
+        ok = runFrame(present);
+    } catch (...) {
+        apu->setMuted(false);
+        throw;
+    }
+    apu->setMuted(false);
+    return ok;
+}
+
+void Core::Console::saveSnapshot(std::vector<u8> &out) {
+    out.clear();
+    if (!isLoaded())
+        return;
+
+    scheduler.sync();
+
+    SaveState state;
+    state.cpu = cpu->getState();
+    state.ppu = ppu->getState();
+    state.apu = apu->getState();
+    state.mem = mem->getState();
+    state.mapper = mapper->getState();
+    state.region = static_cast<u8>(region);
+    state.frameCount = frameCount;
+    state.cpuCycle = scheduler.getCpuCycle();
+
+    encodeState(state, out);
+}
+
+void Core::Console::loadSnapshot(const std::vector<u8> &data,
+                                 bool keepAudio) {
+    if (!isLoaded())
+        return;
+
+    SaveState state;
+    if (!decodeState(data.data(), data.size(), state))
+        throw std::runtime_error("[STATE]: Повреждённый снимок");
+
+    if (state.mapper.mapperNumber != mapper->mapperNumber)
+        throw std::runtime_error("[STATE]: Снимок сделан с другим маппером");
+    if (state.region > static_cast<u8>(PPU::Region::DENDY))
+        throw std::runtime_error("[STATE]: Неизвестный регион в снимке");
+
+    /* Маппер первым: Memory::loadState перестраивает таблицы страниц,
+     * а испорченные регистры маппера отвергаются до смены региона */
+    mapper->loadState(state.mapper);
+
+    /* Регион снимка задаёт соотношение тактов: сменить до restoreClock() */
+    if (static_cast<PPU::Region>(state.region) != region) {
+        region = static_cast<PPU::Region>(state.region);
+        applyRegion();
+    }
+    cpu->loadState(state.cpu);
+    ppu->loadState(state.ppu);
+    if (keepAudio)
+        apu->restoreState(state.apu);
+    else
+        apu->loadState(state.apu);
+    mem->loadState(state.mem);
+    frameCount = state.frameCount;
+
+    scheduler.restoreClock(state.cpuCycle);
+}
+
+auto Core::Console::stateHash() -> StateHash {
+    using Common::Hash::xxh64;
+
+    StateHash h;
+    if (!isLoaded())
+        return h;
+
+    scheduler.sync();
+
+    /* Регистры побайтно: в структурах State есть выравнивание */
+    const auto &regs = cpu->getState().regs;
+    const u64 cycle = scheduler.getCpuCycle();
+    const u8 cpuRegs[] = {
+        regs.A,
+        regs.X,
+        regs.Y,
+        regs.P,
+        regs.SP,
+        static_cast<u8>(regs.PC),
+        static_cast<u8>(regs.PC >> 8),
+        static_cast<u8>(cpu->getState().do_nmi),
+        static_cast<u8>(cpu->getState().do_irq),
+    };
+    h.parts[StateHash::CPU] =
+        xxh64(&cycle, sizeof(cycle), xxh64(cpuRegs, sizeof(cpuRegs)));
+
+    const auto &ram = mem->getState().ram;
+    h.parts[StateHash::RAM] = xxh64(ram.data(), ram.size());
+
+    const auto &ps = ppu->getState();
+    const u8 ppuRegs[] = {
+        ps.ppuctrl,
+        ps.ppumask,
+        ps.ppustatus,
+        ps.oamaddr,
+        ps.w,
+        ps.fineX,
+        static_cast<u8>(ps.v),
+        static_cast<u8>(ps.v >> 8),
+        static_cast<u8>(ps.t),
+        static_cast<u8>(ps.t >> 8),
+        ps.dataBuffer,
+        static_cast<u8>(ps.pixel),
+        static_cast<u8>(ps.pixel >> 8),
+        static_cast<u8>(ps.scanline),
+        static_cast<u8>(ps.scanline >> 8),
+        static_cast<u8>(ps.oddFrame),
+        ps.openBus,
+    };
+    h.parts[StateHash::PPU] = xxh64(ppuRegs, sizeof(ppuRegs));
+    h.parts[StateHash::VRAM] = xxh64(ps.vram.data(), ps.vram.size());
+    h.parts[StateHash::OAM] = xxh64(ps.oam.data(), ps.oam.size());
+    h.parts[StateHash::PALETTE] = xxh64(ps.pal.data(), ps.pal.size());
+
+    const u8 mapperRegs[] = {
+        mapper->mapperNumber,
+        static_cast<u8>(mapper->mirror),
+        static_cast<u8>(mapper->irqFlag),
+    };
+    const std::vector<u8> blob = mapper->registerBlob();
+    u64 m = xxh64(mapperRegs, sizeof(mapperRegs));
+    m = xxh64(mapper->prgMap.data(), sizeof(mapper->prgMap), m);
+    m = xxh64(mapper->chrMap.data(), sizeof(mapper->chrMap), m);
+    m = xxh64(blob.data(), blob.size(), m);
+    m = xxh64(mapper->PRG_RAM.data(), mapper->PRG_RAM.size(), m);
+    if (mapper->chrRam)
+        m = xxh64(mapper->CHR_ROM.data(), mapper->CHR_ROM.size(), m);
+    h.parts[StateHash::MAPPER] = m;
+
+    return h;
+}
+
+bool Core::Console::runFrameAhead(u32 frames) {
+    /* Настоящий кадр при run-ahead не показывается */
+    if (!runFrame(frames == 0))
+        return false;
+
+    if (frames == 0)
+        return true;
+
+    saveSnapshot(aheadSnapshot);
+
+    /* Спекулятивные кадры: показывается только последний */
+    bool ok = true;
+    for (u32 i = 0; i < frames && ok; ++i)
+        ok = runFrameMuted(i + 1 == frames);
+
+    loadSnapshot(aheadSnapshot, true);
+    return ok;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "common/types.h"
+
+#include "core/apu.h"
+#include "core/cpu.h"
+#include "core/mapper.h"
+#include "core/mem.h"
+#include "core/ppu.h"
+#include "core/scheduler.h"
+#include "core/statehash.h"
+
+namespace Core {
+class Console {
+public:
+    /* Защита от зависания, если PPU так и не выставил frameReady */
+    static inline constexpr u32 MAX_CPU_INSTRUCTIONS_PER_FRAME = 2000000;
+
+public:
+    explicit Console() = default;
+    ~Console() = default;
+
+    Console(const Console &) = delete;
+    auto operator=(const Console &) -> Console & = delete;
+
+    void loadRom(const std::filesystem::path &romPath,
+                 const std::filesystem::path &mapperDir = "mappers/");
+
+    /* Тот же ROM, что в source, без повторного чтения файла (маппер
+     * создаётся заново, Lua-скрипт тоже открывается заново) */
+    void loadRom(const Console &source,
+                 const std::filesystem::path &mapperDir = "mappers/");
+    void unload();
+    void reset();
+
+    void setRegion(PPU::Region region);
+    PPU::Region getRegion() const { return region; }
+
+    bool isLoaded() const { return mapper && ppu && apu && mem && cpu; }
+
+    void setJoy1(u8 s) {
+        if (mem)
+            mem->setJoy1(s);
+    }
+    void setJoy2(u8 s) {
+        if (mem)
+            mem->setJoy2(s);
+    }
+
+    /* Одна инструкция CPU; PPU/APU догоняются планировщиком по событиям */
+    void runInstruction();
+
+    /* Догнать PPU/APU до CPU (перед чтением их состояния снаружи) */
+    void sync() { scheduler.sync(); }
+
+    /* Эмуляция до следующего VBlank; false при срабатывании защиты.
+     * present = false - кадр не покажут (PPU::skipOutput на время кадра) */
+    bool runFrame(bool present = true);
+
+    /* То же без звука: samples и blip не трогаются (кадры, которые
+     * потом будут отменены откатом или пропущены перемоткой) */
+    bool runFrameMuted(bool present = true);
+
+    u64 getFrameCount() const { return frameCount; }
+    u64 getInstructionCount() const { return instructionCount; }
+
+    /* Снимок всего состояния консоли в формате save state (savestate.h).
+     * Перед снимком PPU/APU догоняются до CPU, так что при загрузке
+     * достаточно восстановить такт CPU, регион тоже берётся из снимка.
+     * keepAudio - не сбрасывать blip и samples (откат run-ahead/netplay
+     * посреди идущего звука) */
+    void saveSnapshot(std::vector<u8> &out);
+    void loadSnapshot(const std::vector<u8> &data, bool keepAudio = false);
+
+    /* Хэши состояния на текущий момент (обычно после runFrame()):
+     * несколько микросекунд, можно звать каждый кадр */
+    auto stateHash() -> StateHash;
+
+    /* Run-ahead: настоящий кадр со звуком, затем ещё frames кадров с тем
+     * же вводом без звука, показ последнего из них и откат к настоящему.
+     * Реакция игры на ввод видна на frames кадров раньше; звук и
+     * состояние те же, что у runFrame(). frames = 0 - обычный runFrame() */
+    bool runFrameAhead(u32 frames);
+
+    /* Такты компонентов с последнего сброса часов (для бенчмарков) */
+    const Scheduler &getScheduler() const { return scheduler; }
+
+public:
+    /* Загружать mpN.lua вместо встроенных мапперов (для отладки скриптов) */
+    bool luaMappers{false};
+
+    std::unique_ptr<Mapper> mapper;
+    std::unique_ptr<PPU> ppu;
+    std::unique_ptr<APU> apu;
+    std::unique_ptr<Memory> mem;
+    std::unique_ptr<CPU> cpu;
+
+private:
+    /* Всё, кроме картриджа: маппер, PPU, APU, память, CPU */
+    void powerUp(const std::filesystem::path &mapperDir);
+    void attach();
+    void applyRegion();
+    bool stepFrame();
+
+    Scheduler scheduler;
+    PPU::Region region{PPU::Region::NTSC};
+    u64 frameCount{0};
+    u64 instructionCount{0};
+
+    /* Снимок настоящего кадра для run-ahead, буфер переиспользуется */
+    std::vector<u8> aheadSnapshot;
+};
+
+} /* namespace Core */
@@ -1,5 +1,3 @@
-#include <array>
-
 #include "core/cpu.h"
 #include "core/cpu_op.h"
 
@@ -22,8 +20,8 @@ void CPU::reset() {
     c.do_irq = 0;
     c.page_crossed = 0;
     debugTraceCounter = 0;
-    c.opEntry.op_name = "";
-    c.opEntry.am = C6502::IMP;
+    c.opcode = 0xEA;
+    c.AM = C6502::IMP;
 }
 
 /* Линии прерываний */
@@ -46,49 +44,41 @@ void CPU::C6502::irq() {
 }
 
 /* Выполнение одной инструкции */
-void CPU::C6502::step() {
-    const u8 opcode = p->memRead(regs.PC++);
-
-    static const std::array<const OpEntry *, 256> opLut = []() {
-        std::array<const OpEntry *, 256> lut{};
-        lut.fill(nullptr);
-
-        for (const auto &kv : OP_TABLE) {
-            const u8 op = static_cast<u8>(kv.first & 0xFF);
-            lut[op] = &kv.second;
-        }
-
-        return lut;
-    }();
-
-    const OpEntry *op = opLut[opcode];
-    if (!op) {
-        p->c.opEntry.op_name = "???";
-        p->c.opEntry.am = IMP;
-        op_cycles = 2;
-        page_crossed = 0;
-        return;
-    }
+#define OP_CASE(n)                                                             \
+    case (n):                                                                  \
+        execOp<(n)>();                                                         \
+        break;
+#define OP_CASE4(n) OP_CASE(n) OP_CASE(n + 1) OP_CASE(n + 2) OP_CASE(n + 3)
+#define OP_CASE16(n)                                                           \
+    OP_CASE4(n) OP_CASE4(n + 4) OP_CASE4(n + 8) OP_CASE4(n + 12)
 
-    p->c.opEntry.op_name = op->op_name;
-    p->c.opEntry.am = op->am;
-    op_cycles = op->cycles;
-    page_crossed = 0;
-
-    if (op->op_imp != nullptr) {
-        (this->*op->op_imp)();
-        return;
-    }
-
-    if (op->op_addr != nullptr) {
-        const u16 addr = resolveAddr(op->am);
-        (this->*op->op_addr)(addr);
-
-        if (op->page_crossed && page_crossed)
-            op_cycles += 1;
+void CPU::C6502::step() {
+    opcode = p->memRead(regs.PC++);
+
+    switch (opcode) {
+        OP_CASE16(0x00)
+        OP_CASE16(0x10)
+        OP_CASE16(0x20)
+        OP_CASE16(0x30)
+        OP_CASE16(0x40)
+        OP_CASE16(0x50)
+        OP_CASE16(0x60)
+        OP_CASE16(0x70)
+        OP_CASE16(0x80)
+        OP_CASE16(0x90)
+        OP_CASE16(0xA0)
+        OP_CASE16(0xB0)
+        OP_CASE16(0xC0)
+        OP_CASE16(0xD0)
+        OP_CASE16(0xE0)
+        OP_CASE16(0xF0)
     }
 }
 
+#undef OP_CASE16
+#undef OP_CASE4
+#undef OP_CASE
+
 void CPU::exec() {
     if (!mem)
         return;
@@ -121,4 +111,8 @@ void CPU::exec() {
     tickCycles(c.op_cycles);
 }
 
+const char *CPU::getLastOpName() const {
+    return C6502::OP_TABLE[c.opcode].op_name;
+}
+
 } /* namespace Core */
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <unordered_map>
+#include <array>
 
 #include "common/types.h"
 
@@ -28,13 +28,13 @@ private:
     inline u8 memRead(u16 addr) const {
         if (!mem)
             return 0;
-        return mem->read(addr);
+        return mem->cpuRead(addr);
     }
 
     inline void memWrite(u16 addr, u8 value) {
         if (!mem)
             return;
-        mem->write(addr, value);
+        mem->cpuWrite(addr, value);
     }
 
 public:
@@ -100,7 +100,7 @@ public:
             IND,  /* Indirect     */
             INDX, /* Indirect, X */
             INDY, /* Indirect, Y */
-        } AM;
+        } AM{IMP};
 
     public:
         State::Regs &regs;
@@ -119,10 +119,18 @@ public:
             bool page_crossed;
         };
 
-        static const std::unordered_map<u16, OpEntry> OP_TABLE;
+        struct OpDef {
+            u8 opcode;
+            OpEntry entry;
+        };
+
+        static const OpDef OP_LIST[];
+        static constexpr auto makeOpTable() -> std::array<OpEntry, 256>;
 
     public:
-        OpEntry opEntry{};
+        static const std::array<OpEntry, 256> OP_TABLE;
+
+        u8 opcode{0xEA}; /* Последний исполненный опкод */
 
     private:
         /* Утилиты */
@@ -219,37 +227,35 @@ public:
         }
 
     private:
-        inline u16 resolveAddr(AddrMode am) {
-            switch (am) {
-            case IMM:
+        template <AddrMode MODE> inline u16 resolveAddr() {
+            if constexpr (MODE == IMM)
                 return AM_IMM();
-            case IMP:
-                return AM_IMP();
-            case ZPG:
+            else if constexpr (MODE == ZPG)
                 return AM_ZPG();
-            case ZPGX:
+            else if constexpr (MODE == ZPGX)
                 return AM_ZPX();
-            case ZPGY:
+            else if constexpr (MODE == ZPGY)
                 return AM_ZPY();
-            case REL:
+            else if constexpr (MODE == REL)
                 return AM_REL();
-            case ABS:
+            else if constexpr (MODE == ABS)
                 return AM_ABS();
-            case ABSX:
+            else if constexpr (MODE == ABSX)
                 return AM_ABX();
-            case ABSY:
+            else if constexpr (MODE == ABSY)
                 return AM_ABY();
-            case IND:
+            else if constexpr (MODE == IND)
                 return AM_IND();
-            case INDX:
+            else if constexpr (MODE == INDX)
                 return AM_INX();
-            case INDY:
+            else if constexpr (MODE == INDY)
                 return AM_INY();
-            }
-
-            return AM_IMP();
+            else
+                return AM_IMP();
         }
 
+        template <u8 OPCODE> inline void execOp();
+
     private:
         /* Вспомогательные функции */
         inline void ArithmWithCarry(const u16 val);
@@ -358,8 +364,8 @@ public:
     C6502 c{this};
 
 public:
-    const char *getLastOpName() const { return c.opEntry.op_name; }
-    C6502::AddrMode getLastAddrMode() const { return c.opEntry.am; }
+    const char *getLastOpName() const;
+    C6502::AddrMode getLastAddrMode() const { return c.AM; }
 };
 
 } /* namespace Core */
@@ -5,6 +5,71 @@
 #include "core/cartridge.h"
 #include "core/lua.h"
 
+/* Загрузка скрипта маппера и кэширование его функций */
+void Core::Lua::open(const std::filesystem::path &path) {
+    lua_settop(L, 0);
+    lua_pushlightuserdata(L, this);
+    lua_setglobal(L, "__instance");
+
+    const std::filesystem::path mapperDir = path.parent_path();
+
+    lua_getglobal(L, "package");
+    lua_getfield(L, -1, "path");
+    const char *oldPath = lua_tostring(L, -1);
+    const std::string prevPath = oldPath ? oldPath : "";
+    lua_pop(L, 1);
+
+    const std::string newPath =
+        (mapperDir / "?.lua").generic_string() + ";" + prevPath;
+    lua_pushlstring(L, newPath.c_str(), newPath.size());
+    lua_setfield(L, -2, "path");
+    lua_pop(L, 1);
+
+    lua_pushinteger(L, PRG_ROM.size());
+    lua_setglobal(L, "prgSize");
+
+    lua_pushinteger(L, PRG_RAM.size());
+    lua_setglobal(L, "prgRamSize");
+
+    lua_pushinteger(L, CHR_ROM.size());
+    lua_setglobal(L, "chrSize");
+
+    /* Загружаем файл */
+    if (luaL_dofile(L, path.string().c_str()) != LUA_OK)
+        throw std::runtime_error("[LUA]: " + luaError());
+
+    if (!lua_istable(L, -1))
+        throw std::runtime_error("[LUA]: Скрипт должен возвращать таблицу");
+
+    /* Вызываем init */
+    lua_getfield(L, -1, "init");
+    if (lua_isfunction(L, -1)) {
+        lua_pushvalue(L, -2);
+        if (lua_pcall(L, 1, 0, 0) != LUA_OK)
+            throw std::runtime_error("[LUA]: " + luaError());
+    } else
+        lua_pop(L, 1);
+
+    /* Кэшируем функции */
+    cacheFunc("readPRGAddr");
+    cacheFunc("readCHRAddr");
+    cacheFunc("writePRGAddr");
+    cacheFunc("writeCHRAddr");
+    cacheFunc("step");
+    cacheFunc("saveState");
+    cacheFunc("loadState");
+
+    lua_settop(L, IDX_LOAD_STATE);
+
+    hasReadPRG = !lua_isnil(L, IDX_READ_PRG);
+    hasReadCHR = !lua_isnil(L, IDX_READ_CHR);
+    hasWritePRG = !lua_isnil(L, IDX_WRITE_PRG);
+    hasWriteCHR = !lua_isnil(L, IDX_WRITE_CHR);
+    hasStep = !lua_isnil(L, IDX_STEP);
+    hasSaveState = !lua_isnil(L, IDX_SAVE_STATE);
+    hasLoadState = !lua_isnil(L, IDX_LOAD_STATE);
+}
+
 API_EXPORT void Cartridge_resize(void *instance, u8 vecType, size_t size) {
     auto *cart = static_cast<Core::Cartridge *>(instance);
 
@@ -17,15 +82,16 @@ API_EXPORT void Cartridge_resize(void *instance, u8 vecType, size_t size) {
         break;
     case 2: /* VEC_CHR_ROM */
         cart->CHR_ROM.resize(size);
+        cart->invalidateCHR();
         break;
     default:
         break;
     }
+    cart->storageChanged();
 }
 
 API_EXPORT void Cartridge_setMirror(void *instance, u8 mode) {
-    static_cast<Core::Cartridge *>(instance)->mirror =
-        static_cast<Core::Cartridge::MirrorMode>(mode);
+    static_cast<Core::Cartridge *>(instance)->setMirror(mode);
 }
 
 API_EXPORT void Cartridge_triggerIRQ(void *instance) {
@@ -35,3 +101,15 @@ API_EXPORT void Cartridge_triggerIRQ(void *instance) {
 API_EXPORT void Cartridge_clearIRQ(void *instance) {
     static_cast<Core::Cartridge *>(instance)->irqFlag = false;
 }
+
+/* Окно PRG по 8 КБ: slot 0-3 -> $8000/$A000/$C000/$E000 */
+API_EXPORT void Cartridge_mapPRG(void *instance, u8 slot, u32 offset) {
+    static_cast<Core::Cartridge *>(instance)->mapPRG(slot, offset);
+}
+
+/* Окно CHR по 1 КБ: slot 0-7 -> $0000-$1C00 */
+API_EXPORT void Cartridge_mapCHR(void *instance, u8 slot, u32 offset) {
+    auto *cart = static_cast<Core::Cartridge *>(instance);
+    cart->chrMap[slot & 0x07] = offset;
+    cart->chrBanked = true;
+}
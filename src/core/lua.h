@@ -50,74 +50,18 @@ public:
             lua_close(L);
     }
 
-    void open(const std::filesystem::path &path) {
-        lua_settop(L, 0);
-        lua_pushlightuserdata(L, this);
-        lua_setglobal(L, "__instance");
-
-        const std::filesystem::path mapperDir = path.parent_path();
-
-        lua_getglobal(L, "package");
-        lua_getfield(L, -1, "path");
-        const char *oldPath = lua_tostring(L, -1);
-        const std::string prevPath = oldPath ? oldPath : "";
-        lua_pop(L, 1);
-
-        const std::string newPath =
-            (mapperDir / "?.lua").generic_string() + ";" + prevPath;
-        lua_pushlstring(L, newPath.c_str(), newPath.size());
-        lua_setfield(L, -2, "path");
-        lua_pop(L, 1);
-
-        lua_pushinteger(L, PRG_ROM.size());
-        lua_setglobal(L, "prgSize");
-
-        lua_pushinteger(L, PRG_RAM.size());
-        lua_setglobal(L, "prgRamSize");
-
-        lua_pushinteger(L, CHR_ROM.size());
-        lua_setglobal(L, "chrSize");
-
-        /* Загружаем файл */
-        if (luaL_dofile(L, path.string().c_str()) != LUA_OK)
-            throw std::runtime_error("[LUA]: " + luaError());
-
-        if (!lua_istable(L, -1))
-            throw std::runtime_error("[LUA]: Скрипт должен возвращать таблицу");
-
-        /* Вызываем init */
-        lua_getfield(L, -1, "init");
-        if (lua_isfunction(L, -1)) {
-            lua_pushvalue(L, -2);
-            if (lua_pcall(L, 1, 0, 0) != LUA_OK)
-                throw std::runtime_error("[LUA]: " + luaError());
-        } else
-            lua_pop(L, 1);
-
-        /* Кэшируем функции */
-        cacheFunc("readPRGAddr");
-        cacheFunc("readCHRAddr");
-        cacheFunc("writePRGAddr");
-        cacheFunc("writeCHRAddr");
-        cacheFunc("step");
-        cacheFunc("saveState");
-        cacheFunc("loadState");
+    /* Сколько раз вызывались функции маппера (read/write/step) */
+    u64 getCallCount() const { return callCount; }
 
-        lua_settop(L, IDX_LOAD_STATE);
-
-        hasReadPRG = !lua_isnil(L, IDX_READ_PRG);
-        hasReadCHR = !lua_isnil(L, IDX_READ_CHR);
-        hasWritePRG = !lua_isnil(L, IDX_WRITE_PRG);
-        hasWriteCHR = !lua_isnil(L, IDX_WRITE_CHR);
-        hasStep = !lua_isnil(L, IDX_STEP);
-        hasSaveState = !lua_isnil(L, IDX_SAVE_STATE);
-        hasLoadState = !lua_isnil(L, IDX_LOAD_STATE);
-    }
+    /* Определён в lua.cpp рядом с FFI-экспортами, чтобы при статической
+     * линковке nespp_core они не выбрасывались линковщиком */
+    void open(const std::filesystem::path &path);
 
 public:
     inline void step() {
         if (!hasStep)
             return;
+        ++callCount;
         lua_pushvalue(L, IDX_STEP);
         lua_pushvalue(L, IDX_SELF);
         if (lua_pcall(L, 1, 0, 0) != LUA_OK)
@@ -162,6 +106,7 @@ public:
 
 protected:
     lua_State *L;
+    u64 callCount{0};
     bool hasReadPRG{false};
     bool hasReadCHR{false};
     bool hasWritePRG{false};
@@ -171,6 +116,7 @@ protected:
     bool hasLoadState{false};
 
     inline u32 callFunc(int idx, u16 addr) {
+        ++callCount;
         lua_pushvalue(L, idx);
         lua_pushvalue(L, IDX_SELF);
         lua_pushinteger(L, addr);
@@ -203,6 +149,7 @@ protected:
     }
 
     inline u32 callFunc(int idx, u16 addr, u8 value) {
+        ++callCount;
         lua_pushvalue(L, idx);
         lua_pushvalue(L, IDX_SELF);
         lua_pushinteger(L, addr);
@@ -268,3 +215,5 @@ API_EXPORT void Cartridge_resize(void *instance, u8 vecType, size_t size);
 API_EXPORT void Cartridge_setMirror(void *instance, u8 mode);
 API_EXPORT void Cartridge_triggerIRQ(void *instance);
 API_EXPORT void Cartridge_clearIRQ(void *instance);
+API_EXPORT void Cartridge_mapPRG(void *instance, u8 slot, u32 offset);
+API_EXPORT void Cartridge_mapCHR(void *instance, u8 slot, u32 offset);
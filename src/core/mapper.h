@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 #include "core/lua.h"
+#include "core/mappers/native.h"
 
 namespace Core {
 class Mapper : public Lua {
@@ -13,14 +17,50 @@ public:
 public:
     bool debug{false};
 
+    /* Всегда брать mpN.lua, даже если есть встроенный маппер */
+    bool forceLua{false};
+
+    /* Встроенный маппер выбирается по номеру, иначе mpN.lua из srcPath */
     void load(const std::filesystem::path &srcPath = "mappers/") {
+        native = forceLua ? nullptr : NativeMapper::create(mapperNumber, *this);
+        if (native) {
+            native->init();
+            return;
+        }
+
         std::filesystem::path path =
             srcPath / ("mp" + std::to_string(mapperNumber) + ".lua");
         open(path);
     }
 
+    bool isNative() const { return native != nullptr; }
+
+    /* Маппер считает scanline через step() (IRQ по строкам) */
+    bool needsStep() const { return native ? native->stepped : hasStep; }
+
+    inline void step() {
+        if (native)
+            native->step();
+        else
+            Lua::step();
+    }
+
+    /* Lua-маппер может поднять IRQ на любом step() */
+    u32 stepsUntilIRQ() const {
+        return native ? native->stepsUntilIRQ() : 1;
+    }
+
 public:
+    /* Для банковых мапперов (все встроенные, в том числе MMC3) CPU читает
+     * PRG по таблице страниц Memory; сюда приходят только страницы под
+     * watchpoint-ом и окна за пределами PRG_ROM */
     inline u8 readPRG(u16 addr) {
+        if (prgBanked) {
+            const u32 mappedAddr =
+                prgMap[(addr >> 13) & 0x03] + (addr & 0x1FFF);
+            return (mappedAddr < PRG_ROM.size()) ? PRG_ROM[mappedAddr] : 0;
+        }
+
         const u32 mappedAddr =
             (!hasReadPRG) ? addr : callFunc(IDX_READ_PRG, addr);
 
@@ -34,6 +74,16 @@ public:
     }
 
     inline u8 readCHR(u16 addr) {
+        if (chrBanked) {
+            const u32 mappedAddr =
+                chrMap[(addr >> 10) & 0x07] + (addr & 0x03FF);
+            const u8 value =
+                (mappedAddr < CHR_ROM.size()) ? CHR_ROM[mappedAddr] : 0;
+            if (native && native->chrReadHook)
+                native->readCHR(addr);
+            return value;
+        }
+
         const u32 mappedAddr =
             (!hasReadCHR) ? addr : callFunc(IDX_READ_CHR, addr);
 
@@ -46,9 +96,30 @@ public:
         return 0;
     }
 
-    inline u8 readRAM(u16 addr) { return PRG_RAM[addr & 0x1FFF]; }
+    /* Строку тайла можно брать из кэша: CHR отображён таблицей банков и
+     * чтение CHR не переключает защёлки (MMC2) */
+    inline bool chrRowCached() const {
+        return chrBanked && !(native && native->chrReadHook);
+    }
+
+    /* Строка тайла по адресу плоскости low ($0000-$1FFF), только при
+     * chrRowCached(): то же, что readCHR(addr) и readCHR(addr + 8) */
+    inline CHRRow readCHRRow(u16 addr) {
+        return chrRow(chrMap[(addr >> 10) & 0x07] + (addr & 0x03FF));
+    }
+
+    /* PRG_RAM может быть меньше 8 КБ (resizePRG_RAM, чужой savestate) */
+    inline u8 readRAM(u16 addr) {
+        const u16 offset = addr & 0x1FFF;
+        return (offset < PRG_RAM.size()) ? PRG_RAM[offset] : 0;
+    }
 
     inline void writePRG(u16 addr, u8 value) {
+        if (native) {
+            native->writePRG(addr, value);
+            return;
+        }
+
         const u32 mappedAddr =
             (!hasWritePRG) ? addr : callFunc(IDX_WRITE_PRG, addr, value);
 
@@ -61,6 +132,20 @@ public:
     }
 
     inline void writeCHR(u16 addr, u8 value) {
+        if (chrBanked && !hasWriteCHR) {
+            if (!chrRam)
+                return;
+            const u32 mappedAddr =
+                chrMap[(addr >> 10) & 0x07] + (addr & 0x03FF);
+            if (mappedAddr < CHR_ROM.size()) {
+                CHR_ROM[mappedAddr] = value;
+                invalidateCHR(mappedAddr);
+            }
+            if (native && native->chrReadHook)
+                native->readCHR(addr);
+            return;
+        }
+
         const u32 mappedAddr =
             (!hasWriteCHR) ? addr : callFunc(IDX_WRITE_CHR, addr, value);
 
@@ -69,10 +154,16 @@ public:
 
         if (mappedAddr < CHR_ROM.size()) {
             CHR_ROM[mappedAddr] = value;
+            invalidateCHR(mappedAddr);
         }
     }
 
-    inline void writeRAM(u16 addr, u8 value) { PRG_RAM[addr & 0x1FFF] = value; }
+    inline void writeRAM(u16 addr, u8 value) {
+        const u16 offset = addr & 0x1FFF;
+        if (offset < PRG_RAM.size())
+            PRG_RAM[offset] = value;
+    }
+
 
 public:
     struct State {
@@ -92,22 +183,69 @@ public:
         s.prgRam = PRG_RAM;
         if (chrRam)
             s.chrRam = CHR_ROM;
-        s.mapperBlob = saveMapperState();
+        s.mapperBlob = registerBlob();
         state = s;
         return s;
     }
 
+    /* Внутренние регистры маппера (mapperBlob в State). Сторонний
+     * Lua-скрипт без saveState/loadState снимается без них: хэш, run-ahead
+     * и save state работают, но банки после загрузки могут разойтись, о
+     * чём предупреждаем один раз */
+    auto registerBlob() -> std::vector<u8> {
+        if (native)
+            return native->saveState();
+        if (!hasStateFuncs()) {
+            warnStateless();
+            return {};
+        }
+        return saveMapperState();
+    }
+
     void loadState(const State &newState) {
+        /* Регистры первыми: испорченный блок отвергается до того, как
+         * что-то изменилось. Блок, который скрипт не может прочитать, -
+         * ошибка, пустой блок такому скрипту просто не нужен */
+        if (native) {
+            native->loadState(newState.mapperBlob);
+        } else if (hasStateFuncs()) {
+            loadMapperState(newState.mapperBlob);
+        } else if (!newState.mapperBlob.empty()) {
+            throw std::runtime_error(
+                "[LUA]: Маппер " + std::to_string(mapperNumber) +
+                " без loadState не может загрузить регистры из снимка");
+        } else {
+            warnStateless();
+        }
+
         mapperNumber = newState.mapperNumber;
-        mirror = static_cast<Cartridge::MirrorMode>(newState.mirrorMode);
+        setMirror(newState.mirrorMode);
         irqFlag = newState.irqFlag;
         if (!newState.prgRam.empty())
             PRG_RAM = newState.prgRam;
-        if (chrRam && !newState.chrRam.empty())
+        if (chrRam && !newState.chrRam.empty()) {
             CHR_ROM = newState.chrRam;
-        loadMapperState(newState.mapperBlob);
+            invalidateCHR();
+        }
         this->state = newState;
+        storageChanged();
     }
+
+private:
+    bool hasStateFuncs() const { return hasSaveState && hasLoadState; }
+
+    void warnStateless() {
+        if (statelessWarned)
+            return;
+        statelessWarned = true;
+        std::fprintf(stderr,
+                     "[LUA]: Маппер %u без saveState/loadState: регистры "
+                     "маппера в снимок не попадают\n",
+                     static_cast<unsigned>(mapperNumber));
+    }
+
+    std::unique_ptr<NativeMapper> native;
+    bool statelessWarned{false};
 };
 
 } /* namespace Core */
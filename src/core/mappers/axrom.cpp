@@ -0,0 +1,32 @@
+#include "core/mapper.h"
+#include "core/mappers/native.h"
+
+void Core::AxROM::init() {
+    r = Regs{};
+    prgBankCount = prgSize() / 0x8000;
+
+    if (chrRam())
+        resizeCHR(0x2000);
+
+    mapCHR(0, 0x0000, 8);
+    updateBanks();
+}
+
+void Core::AxROM::writePRG(u16 addr, u8 value) {
+    if (addr < 0x8000)
+        return;
+
+    r.prgBank = value & 0x07;
+    setMirror((value & 0x10) ? Mapper::SINGLE_UP : Mapper::SINGLE_DOWN);
+    updateBanks();
+}
+
+void Core::AxROM::loadState(const std::vector<u8> &data) {
+    BlobReader in(data, sizeof(Regs));
+    r.prgBank = in.byte() & 0x07;
+    updateBanks();
+}
+
+void Core::AxROM::updateBanks() {
+    mapPRG(0, maskBank(r.prgBank, prgBankCount) * 0x8000u, 4);
+}
@@ -0,0 +1,33 @@
+#include "core/mappers/native.h"
+
+void Core::CNROM::init() {
+    r = Regs{};
+
+    if (chrRam()) {
+        resizeCHR(0x2000);
+        chrBankCount = 1;
+    } else
+        chrBankCount = chrSize() / 0x2000;
+
+    /* 16 КБ PRG зеркалится в $C000-$FFFF */
+    if (prgSize() == 0x4000) {
+        mapPRG(0, 0x0000, 2);
+        mapPRG(2, 0x0000, 2);
+    } else
+        mapPRG(0, 0x0000, 4);
+
+    updateBanks();
+}
+
+void Core::CNROM::writePRG(u16 /*addr*/, u8 value) {
+    r.chrBank = static_cast<u8>(maskBank(value, chrBankCount));
+    updateBanks();
+}
+
+void Core::CNROM::loadState(const std::vector<u8> &data) {
+    BlobReader in(data, sizeof(Regs));
+    r.chrBank = static_cast<u8>(maskBank(in.byte(), chrBankCount));
+    updateBanks();
+}
+
+void Core::CNROM::updateBanks() { mapCHR(0, r.chrBank * 0x2000u, 8); }
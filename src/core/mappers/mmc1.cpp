@@ -0,0 +1,108 @@
+#include "core/mapper.h"
+#include "core/mappers/native.h"
+
+void Core::MMC1::init() {
+    r = Regs{};
+    prgBankCount = prgSize() / 0x4000;
+
+    if (chrRam())
+        resizeCHR(0x2000);
+
+    updateMirror();
+    updateBanks();
+}
+
+void Core::MMC1::writePRG(u16 addr, u8 value) {
+    if (value & 0x80) {
+        r.shiftReg = 0x10;
+        r.ctrl |= 0x0C;
+        updateMirror();
+        updateBanks();
+        return;
+    }
+
+    const bool fill = (r.shiftReg & 0x01) != 0;
+    r.shiftReg = static_cast<u8>((r.shiftReg >> 1) | ((value & 0x01) << 4));
+
+    if (!fill)
+        return;
+
+    switch ((addr >> 13) & 0x03) {
+    case 0:
+        r.ctrl = r.shiftReg;
+        updateMirror();
+        break;
+    case 1:
+        r.chrBank0 = r.shiftReg;
+        break;
+    case 2:
+        r.chrBank1 = r.shiftReg;
+        break;
+    default:
+        r.prgBank = r.shiftReg & 0x0F;
+        break;
+    }
+
+    r.shiftReg = 0x10;
+    updateBanks();
+}
+
+void Core::MMC1::loadState(const std::vector<u8> &data) {
+    static_assert(sizeof(Regs) == 5);
+    BlobReader in(data, sizeof(Regs));
+    Regs regs;
+    /* Маркер сдвигового регистра - старший установленный бит */
+    regs.shiftReg = in.byte() & 0x1F;
+    if (regs.shiftReg == 0)
+        regs.shiftReg = 0x10;
+    regs.ctrl = in.byte() & 0x1F;
+    regs.chrBank0 = in.byte() & 0x1F;
+    regs.chrBank1 = in.byte() & 0x1F;
+    regs.prgBank = in.byte() & 0x0F;
+
+    r = regs;
+    updateBanks();
+}
+
+void Core::MMC1::updateMirror() {
+    switch (r.ctrl & 0x03) {
+    case 0:
+        setMirror(Mapper::SINGLE_DOWN);
+        break;
+    case 1:
+        setMirror(Mapper::SINGLE_UP);
+        break;
+    case 2:
+        setMirror(Mapper::VERTICAL);
+        break;
+    default:
+        setMirror(Mapper::HORIZONTAL);
+        break;
+    }
+}
+
+void Core::MMC1::updateBanks() {
+    /* PRG: 0/1 - 32 КБ, 2 - первый банк фиксирован, 3 - последний */
+    switch ((r.ctrl >> 2) & 0x03) {
+    case 0:
+    case 1:
+        mapPRG(0, (r.prgBank & 0xFE) * 0x4000u, 4);
+        break;
+    case 2:
+        mapPRG(0, 0x0000, 2);
+        mapPRG(2, r.prgBank * 0x4000u, 2);
+        break;
+    default:
+        mapPRG(0, r.prgBank * 0x4000u, 2);
+        mapPRG(2, (prgBankCount - 1) * 0x4000u, 2);
+        break;
+    }
+
+    /* CHR: 0 - 8 КБ, 1 - два банка по 4 КБ */
+    if ((r.ctrl & 0x10) == 0) {
+        mapCHR(0, (r.chrBank0 & 0xFE) * 0x1000u, 8);
+    } else {
+        mapCHR(0, r.chrBank0 * 0x1000u, 4);
+        mapCHR(4, r.chrBank1 * 0x1000u, 4);
+    }
+}
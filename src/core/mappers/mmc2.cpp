@@ -0,0 +1,103 @@
+#include "core/mapper.h"
+#include "core/mappers/native.h"
+
+void Core::MMC2::init() {
+    r = Regs{};
+    prgBankCount = prgSize() / 0x2000;
+    chrBankCount = chrSize() / 0x1000;
+
+    if (chrRam()) {
+        resizeCHR(0x2000);
+        chrBankCount = 2;
+    }
+
+    updateBanks();
+}
+
+void Core::MMC2::writePRG(u16 addr, u8 value) {
+    if (addr >= 0xA000 && addr <= 0xAFFF) {
+        /* PRG $8000-$9FFF */
+        r.prgBank = value & 0x0F;
+    } else if (addr >= 0xB000 && addr <= 0xBFFF) {
+        /* CHR $0000-$0FFF при latch0 == $FD */
+        r.chrFD0 = value & 0x1F;
+    } else if (addr >= 0xC000 && addr <= 0xCFFF) {
+        /* CHR $0000-$0FFF при latch0 == $FE */
+        r.chrFE0 = value & 0x1F;
+    } else if (addr >= 0xD000 && addr <= 0xDFFF) {
+        /* CHR $1000-$1FFF при latch1 == $FD */
+        r.chrFD1 = value & 0x1F;
+    } else if (addr >= 0xE000 && addr <= 0xEFFF) {
+        /* CHR $1000-$1FFF при latch1 == $FE */
+        r.chrFE1 = value & 0x1F;
+    } else if (addr >= 0xF000) {
+        /* Mirroring: 0 vertical, 1 horizontal */
+        setMirror((value & 0x01) ? Mapper::HORIZONTAL : Mapper::VERTICAL);
+        return;
+    } else
+        return;
+
+    updateBanks();
+}
+
+/* Защёлки переключаются после выборки тайлов $FD/$FE */
+void Core::MMC2::readCHR(u16 addr) {
+    addr &= 0x1FFF;
+
+    u8 latch0 = r.latch0;
+    u8 latch1 = r.latch1;
+
+    if (addr == 0x0FD8)
+        latch0 = 0xFD;
+    else if (addr == 0x0FE8)
+        latch0 = 0xFE;
+    else if (addr >= 0x1FD8 && addr <= 0x1FDF)
+        latch1 = 0xFD;
+    else if (addr >= 0x1FE8 && addr <= 0x1FEF)
+        latch1 = 0xFE;
+
+    if (latch0 == r.latch0 && latch1 == r.latch1)
+        return;
+
+    r.latch0 = latch0;
+    r.latch1 = latch1;
+    updateBanks();
+}
+
+void Core::MMC2::loadState(const std::vector<u8> &data) {
+    static_assert(sizeof(Regs) == 7);
+    BlobReader in(data, sizeof(Regs));
+    Regs regs;
+    regs.prgBank = in.byte() & 0x0F;
+    regs.chrFD0 = in.byte() & 0x1F;
+    regs.chrFE0 = in.byte() & 0x1F;
+    regs.chrFD1 = in.byte() & 0x1F;
+    regs.chrFE1 = in.byte() & 0x1F;
+    regs.latch0 = in.byte();
+    regs.latch1 = in.byte();
+
+    /* Защёлка бывает только $FD или $FE */
+    for (const u8 latch : {regs.latch0, regs.latch1}) {
+        if (latch != 0xFD && latch != 0xFE)
+            throw std::runtime_error(
+                "[STATE]: Неверная защёлка в регистрах MMC2");
+    }
+
+    r = regs;
+    updateBanks();
+}
+
+void Core::MMC2::updateBanks() {
+    const u32 fixedBase = (prgBankCount >= 3) ? prgBankCount - 3 : 0;
+
+    mapPRG(0, maskBank(r.prgBank, prgBankCount) * 0x2000u);
+    for (u8 region = 1; region < 4; ++region)
+        mapPRG(region,
+               maskBank(fixedBase + region - 1, prgBankCount) * 0x2000u);
+
+    const u8 bank0 = (r.latch0 == 0xFD) ? r.chrFD0 : r.chrFE0;
+    const u8 bank1 = (r.latch1 == 0xFD) ? r.chrFD1 : r.chrFE1;
+
+    mapCHR(0, maskBank(bank0, chrBankCount) * 0x1000u, 4);
+    mapCHR(4, maskBank(bank1, chrBankCount) * 0x1000u, 4);
+}
@@ -0,0 +1,124 @@
+#include "core/mapper.h"
+#include "core/mappers/native.h"
+
+void Core::MMC3::init() {
+    r = Regs{};
+    prgBankCount = prgSize() / 0x2000;
+    chrBankCount = chrSize() / 0x0400;
+
+    if (chrRam()) {
+        resizeCHR(0x2000);
+        chrBankCount = 8;
+    }
+
+    setIRQ(false);
+    updateBanks();
+}
+
+void Core::MMC3::writePRG(u16 addr, u8 value) {
+    if (addr < 0x8000)
+        return;
+
+    const bool evenAddr = (addr & 0x01) == 0;
+
+    if (addr <= 0x9FFF) {
+        if (evenAddr) {
+            r.bankSelect = value & 0x07;
+            r.modePRG = (value & 0x40) != 0;
+            r.modeCHR = (value & 0x80) != 0;
+        } else {
+            u8 v = value;
+            if (r.bankSelect <= 1)
+                v &= 0xFE;
+            else if (r.bankSelect >= 6)
+                v &= 0x3F;
+            r.regs[r.bankSelect] = v;
+        }
+        updateBanks();
+    } else if (addr <= 0xBFFF) {
+        /* 0 = vertical, 1 = horizontal */
+        if (evenAddr)
+            setMirror((value & 0x01) ? Mapper::HORIZONTAL : Mapper::VERTICAL);
+    } else if (addr <= 0xDFFF) {
+        if (evenAddr) {
+            /* $C000: IRQ latch */
+            r.irqLatch = value;
+        } else {
+            /* $C001: IRQ reload */
+            r.irqCounter = 0;
+            r.irqReload = true;
+        }
+    } else {
+        if (evenAddr) {
+            /* $E000: IRQ disable */
+            r.irqEnabled = false;
+            setIRQ(false);
+        } else {
+            /* $E001: IRQ enable */
+            r.irqEnabled = true;
+        }
+    }
+}
+
+void Core::MMC3::step() {
+    if (r.irqCounter == 0 || r.irqReload) {
+        r.irqCounter = r.irqLatch;
+        r.irqReload = false;
+    } else
+        --r.irqCounter;
+
+    if (r.irqCounter == 0 && r.irqEnabled)
+        setIRQ(true);
+}
+
+u32 Core::MMC3::stepsUntilIRQ() const {
+    if (!r.irqEnabled)
+        return ~0u;
+    /* Первый step() перезагружает счётчик, затем latch декрементов */
+    if (r.irqCounter == 0 || r.irqReload)
+        return 1u + r.irqLatch;
+    return r.irqCounter;
+}
+
+void Core::MMC3::loadState(const std::vector<u8> &data) {
+    static_assert(sizeof(Regs) == 15);
+    BlobReader in(data, sizeof(Regs));
+    Regs regs;
+    for (u8 &reg : regs.regs)
+        reg = in.byte();
+    /* bankSelect - индекс в regs при записи $8001 */
+    regs.bankSelect = in.byte() & 0x07;
+    regs.modePRG = in.flag();
+    regs.modeCHR = in.flag();
+    regs.irqLatch = in.byte();
+    regs.irqCounter = in.byte();
+    regs.irqReload = in.flag();
+    regs.irqEnabled = in.flag();
+
+    r = regs;
+    updateBanks();
+}
+
+void Core::MMC3::updateBanks() {
+    const u32 r6 = maskBank(r.regs[6], prgBankCount);
+    const u32 r7 = maskBank(r.regs[7], prgBankCount);
+    const u32 secondLast = maskBank(prgBankCount - 2, prgBankCount);
+    const u32 last = maskBank(prgBankCount - 1, prgBankCount);
+
+    mapPRG(0, (r.modePRG ? secondLast : r6) * 0x2000u);
+    mapPRG(1, r7 * 0x2000u);
+    mapPRG(2, (r.modePRG ? r6 : secondLast) * 0x2000u);
+    mapPRG(3, last * 0x2000u);
+
+    const u32 r0 = maskBank(r.regs[0] & 0xFE, chrBankCount);
+    const u32 r1 = maskBank(r.regs[1] & 0xFE, chrBankCount);
+
+    /* Два окна по 2 КБ и четыре по 1 КБ; modeCHR меняет половины */
+    const u8 big = r.modeCHR ? 4 : 0;
+    const u8 small = r.modeCHR ? 0 : 4;
+
+    mapCHR(big + 0, r0 * 0x0400u, 2);
+    mapCHR(big + 2, r1 * 0x0400u, 2);
+    for (u8 i = 0; i < 4; ++i)
+        mapCHR(small + i, maskBank(r.regs[2 + i], chrBankCount) * 0x0400u);
+}
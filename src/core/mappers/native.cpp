@@ -0,0 +1,57 @@
+#include "core/mappers/native.h"
+#include "core/mapper.h"
+
+auto Core::NativeMapper::create(u8 number, Mapper &m)
+    -> std::unique_ptr<NativeMapper> {
+    switch (number) {
+    case 0:
+        return std::make_unique<NROM>(m);
+    case 1:
+        return std::make_unique<MMC1>(m);
+    case 2:
+        return std::make_unique<UxROM>(m);
+    case 3:
+        return std::make_unique<CNROM>(m);
+    case 4:
+        return std::make_unique<MMC3>(m);
+    case 7:
+        return std::make_unique<AxROM>(m);
+    case 9:
+        return std::make_unique<MMC2>(m);
+    default:
+        return nullptr;
+    }
+}
+
+/* slots окон по 8 КБ ($8000-$FFFF), начиная с offset */
+void Core::NativeMapper::mapPRG(u8 slot, u32 offset, u8 slots) {
+    for (u8 i = 0; i < slots; ++i)
+        m.mapPRG(static_cast<u8>(slot + i), offset + i * 0x2000u);
+}
+
+/* slots окон по 1 КБ ($0000-$1FFF), начиная с offset */
+void Core::NativeMapper::mapCHR(u8 slot, u32 offset, u8 slots) {
+    for (u8 i = 0; i < slots; ++i)
+        m.chrMap[(slot + i) & 0x07] = offset + i * 0x0400u;
+    m.chrBanked = true;
+}
+
+void Core::NativeMapper::setMirror(u8 mode) { m.setMirror(mode); }
+
+void Core::NativeMapper::setIRQ(bool level) { m.irqFlag = level; }
+
+u32 Core::NativeMapper::prgSize() const {
+    return static_cast<u32>(m.PRG_ROM.size());
+}
+
+u32 Core::NativeMapper::chrSize() const {
+    return static_cast<u32>(m.CHR_ROM.size());
+}
+
+bool Core::NativeMapper::chrRam() const { return m.chrRam; }
+
+void Core::NativeMapper::resizeCHR(u32 size) {
+    m.CHR_ROM.resize(size);
+    m.invalidateCHR();
+    m.storageChanged();
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "common/types.h"
+
+namespace Core {
+class Mapper;
+
+/* Встроенный маппер на C++.
+ * Регистры маппера раскладываются в таблицы банков Mapper::prgMap/chrMap
+ * только при записи, так что чтение PRG/CHR сводится к поиску по таблице.
+ * Поведение повторяет соответствующие mappers/mp*.lua.
+ */
+class NativeMapper {
+public:
+    explicit NativeMapper(Mapper &m) : m(m) {}
+    virtual ~NativeMapper() = default;
+
+    NativeMapper(const NativeMapper &) = delete;
+    auto operator=(const NativeMapper &) -> NativeMapper & = delete;
+
+    /* nullptr, если для номера нет встроенной реализации */
+    static auto create(u8 number, Mapper &m) -> std::unique_ptr<NativeMapper>;
+
+public:
+    virtual void init() = 0;
+    virtual void writePRG(u16 addr, u8 value) = 0;
+
+    /* Тик scanline-счётчика (только если stepped) */
+    virtual void step() {}
+
+    /* Номер ближайшего вызова step(), который может поднять IRQ (1 -
+     * следующий). Пока IRQ не поднимется, step() ничего, кроме счётчика,
+     * не меняет, и PPU рисует строки до него целиком */
+    virtual u32 stepsUntilIRQ() const { return 1; }
+
+    /* Защёлки, переключаемые чтением CHR (только если chrReadHook) */
+    virtual void readCHR(u16 /*addr*/) {}
+
+    virtual auto saveState() const -> std::vector<u8> = 0;
+    virtual void loadState(const std::vector<u8> &data) = 0;
+
+public:
+    bool stepped{false};
+    bool chrReadHook{false};
+
+protected:
+    /* Маска банка, как lib.maskBank() */
+    static u32 maskBank(u32 bank, u32 count) {
+        return (count == 0) ? 0 : (bank & (count - 1));
+    }
+
+    void mapPRG(u8 slot, u32 offset, u8 slots = 1);
+    void mapCHR(u8 slot, u32 offset, u8 slots = 1);
+    void setMirror(u8 mode);
+    void setIRQ(bool level);
+
+    u32 prgSize() const;
+    u32 chrSize() const;
+    bool chrRam() const;
+    void resizeCHR(u32 size);
+
+    /* Регистры маппера хранятся в POD-структуре из u8/bool и
+     * сохраняются как есть, поле за полем */
+    template <typename T> static auto toBlob(const T &regs) -> std::vector<u8> {
+        std::vector<u8> out(sizeof(T));
+        std::memcpy(out.data(), &regs, sizeof(T));
+        return out;
+    }
+
+    /* Разбор того же блока при загрузке: снимок, запись или netplay могут
+     * быть испорчены, поэтому размер и bool (только 0/1) проверяются,
+     * а не копируются в Regs */
+    class BlobReader {
+    public:
+        BlobReader(const std::vector<u8> &data, sz size) : data(data) {
+            if (data.size() != size)
+                throw std::runtime_error(
+                    "[STATE]: Неверный размер регистров маппера");
+        }
+
+        u8 byte() { return data[pos++]; }
+
+        bool flag() {
+            const u8 value = byte();
+            if (value > 1)
+                throw std::runtime_error(
+                    "[STATE]: Неверный флаг в регистрах маппера");
+            return value != 0;
+        }
+
+    private:
+        const std::vector<u8> &data;
+        sz pos{0};
+    };
+
+    Mapper &m;
+};
+
+/* Mapper 0 (NROM) */
+class NROM : public NativeMapper {
+public:
+    using NativeMapper::NativeMapper;
+
+    void init() override;
+    void writePRG(u16 /*addr*/, u8 /*value*/) override {}
+    auto saveState() const -> std::vector<u8> override { return {}; }
+    void loadState(const std::vector<u8> &data) override {
+        BlobReader in(data, 0);
+    }
+};
+
+/* Mapper 1 (MMC1) */
+class MMC1 : public NativeMapper {
+public:
+    using NativeMapper::NativeMapper;
+
+    void init() override;
+    void writePRG(u16 addr, u8 value) override;
+    auto saveState() const -> std::vector<u8> override { return toBlob(r); }
+    void loadState(const std::vector<u8> &data) override;
+
+private:
+    void updateBanks();
+    void updateMirror();
+
+    struct Regs {
+        u8 shiftReg{0x10};
+        u8 ctrl{0x0C};
+        u8 chrBank0{0};
+        u8 chrBank1{0};
+        u8 prgBank{0};
+    } r{};
+
+    u32 prgBankCount{0};
+};
+
+/* Mapper 2 (UxROM) */
+class UxROM : public NativeMapper {
+public:
+    using NativeMapper::NativeMapper;
+
+    void init() override;
+    void writePRG(u16 addr, u8 value) override;
+    auto saveState() const -> std::vector<u8> override { return toBlob(r); }
+    void loadState(const std::vector<u8> &data) override;
+
+private:
+    void updateBanks();
+
+    struct Regs {
+        u8 prgBank{0};
+    } r{};
+
+    u32 prgBankCount{0};
+};
+
+/* Mapper 3 (CNROM) */
+class CNROM : public NativeMapper {
+public:
+    using NativeMapper::NativeMapper;
+
+    void init() override;
+    void writePRG(u16 addr, u8 value) override;
+    auto saveState() const -> std::vector<u8> override { return toBlob(r); }
+    void loadState(const std::vector<u8> &data) override;
+
+private:
+    void updateBanks();
+
+    struct Regs {
+        u8 chrBank{0};
+    } r{};
+
+    u32 chrBankCount{0};
+};
+
+/* Mapper 4 (MMC3) */
+class MMC3 : public NativeMapper {
+public:
+    explicit MMC3(Mapper &m) : NativeMapper(m) { stepped = true; }
+
+    void init() override;
+    void writePRG(u16 addr, u8 value) override;
+    void step() override;
+    u32 stepsUntilIRQ() const override;
+    auto saveState() const -> std::vector<u8> override { return toBlob(r); }
+    void loadState(const std::vector<u8> &data) override;
+
+private:
+    void updateBanks();
+
+    struct Regs {
+        u8 regs[8]{};
+        u8 bankSelect{0};
+        bool modePRG{false};
+        bool modeCHR{false};
+
+        u8 irqLatch{0};
+        u8 irqCounter{0};
+        bool irqReload{false};
+        bool irqEnabled{false};
+    } r{};
+
+    u32 prgBankCount{0};
+    u32 chrBankCount{0};
+};
+
+/* Mapper 7 (AxROM) */
+class AxROM : public NativeMapper {
+public:
+    using NativeMapper::NativeMapper;
+
+    void init() override;
+    void writePRG(u16 addr, u8 value) override;
+    auto saveState() const -> std::vector<u8> override { return toBlob(r); }
+    void loadState(const std::vector<u8> &data) override;
+
+private:
+    void updateBanks();
+
+    struct Regs {
+        u8 prgBank{0};
+    } r{};
+
+    u32 prgBankCount{0};
+};
+
+/* Mapper 9 (MMC2) */
+class MMC2 : public NativeMapper {
+public:
+    explicit MMC2(Mapper &m) : NativeMapper(m) { chrReadHook = true; }
+
+    void init() override;
+    void writePRG(u16 addr, u8 value) override;
+    void readCHR(u16 addr) override;
+    auto saveState() const -> std::vector<u8> override { return toBlob(r); }
+    void loadState(const std::vector<u8> &data) override;
+
+private:
+    void updateBanks();
+
+    struct Regs {
+        u8 prgBank{0};
+        u8 chrFD0{0};
+        u8 chrFE0{0};
+        u8 chrFD1{0};
+        u8 chrFE1{0};
+        u8 latch0{0xFD};
+        u8 latch1{0xFD};
+    } r{};
+
+    u32 prgBankCount{0};
+    u32 chrBankCount{0};
+};
+
+} /* namespace Core */
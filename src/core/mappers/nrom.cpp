@@ -0,0 +1,15 @@
+#include "core/mappers/native.h"
+
+void Core::NROM::init() {
+    if (chrRam())
+        resizeCHR(0x2000);
+
+    /* 16 КБ PRG зеркалится в $C000-$FFFF */
+    if (prgSize() == 0x4000) {
+        mapPRG(0, 0x0000, 2);
+        mapPRG(2, 0x0000, 2);
+    } else
+        mapPRG(0, 0x0000, 4);
+
+    mapCHR(0, 0x0000, 8);
+}
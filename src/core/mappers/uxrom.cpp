@@ -0,0 +1,28 @@
+#include "core/mappers/native.h"
+
+void Core::UxROM::init() {
+    r = Regs{};
+    prgBankCount = prgSize() / 0x4000;
+
+    if (chrRam())
+        resizeCHR(0x2000);
+
+    mapCHR(0, 0x0000, 8);
+    updateBanks();
+}
+
+void Core::UxROM::writePRG(u16 /*addr*/, u8 value) {
+    r.prgBank = static_cast<u8>(maskBank(value, prgBankCount));
+    updateBanks();
+}
+
+void Core::UxROM::loadState(const std::vector<u8> &data) {
+    BlobReader in(data, sizeof(Regs));
+    r.prgBank = static_cast<u8>(maskBank(in.byte(), prgBankCount));
+    updateBanks();
+}
+
+void Core::UxROM::updateBanks() {
+    mapPRG(0, r.prgBank * 0x4000u, 2);
+    mapPRG(2, (prgBankCount - 1) * 0x4000u, 2);
+}
@@ -1,8 +1,65 @@
 #include "core/mem.h"
 #include "core/apu.h"
 
+void Core::Memory::remap() {
+    readPages.fill(nullptr);
+    writePages.fill(nullptr);
+
+    /* 0x0000-0x1FFF: RAM (2 КБ, зеркалится) */
+    for (u16 page = 0x00; page < 0x20; ++page) {
+        u8 *ptr = &state.ram[(page << 8) & MIRROR];
+        readPages[page] = ptr;
+        writePages[page] = ptr;
+    }
+
+    if (mapper) {
+        /* 0x6000-0x7FFF: PRG-RAM картриджа */
+        auto &prgRam = mapper->PRG_RAM;
+        for (u16 page = 0x60; page < 0x80; ++page) {
+            const u32 offset = (page << 8) & 0x1FFF;
+            if (offset + 0x100 <= prgRam.size()) {
+                readPages[page] = &prgRam[offset];
+                writePages[page] = &prgRam[offset];
+            }
+        }
+
+    }
+
+    for (u16 page = 0; page < 0x100; ++page) {
+        if (watched[page]) {
+            readPages[page] = nullptr;
+            writePages[page] = nullptr;
+        }
+    }
+
+    if (mapper && mapper->prgBanked) {
+        for (u8 slot = 0; slot < 4; ++slot)
+            remapPRG(slot);
+    }
+}
+
+/* 0x8000-0xFFFF: только если маппер опубликовал таблицу банков; запись
+ * всегда уходит мапперу */
+void Core::Memory::remapPRG(u8 slot) {
+    const auto &prgRom = mapper->PRG_ROM;
+    const u16 first = static_cast<u16>(0x80 + slot * 0x20);
+    for (u16 page = first; page < first + 0x20; ++page) {
+        const u32 offset = mapper->prgMap[slot] + ((page & 0x1F) << 8);
+        readPages[page] = (!watched[page] && offset + 0x100 <= prgRom.size())
+                              ? &prgRom[offset]
+                              : nullptr;
+    }
+}
+
+u8 Core::Memory::readSlow(u16 addr) const {
+    const u8 value = readBus(addr);
+    if (watched[addr >> 8] && onWatch)
+        onWatch(addr, value, false);
+    return value;
+}
+
 /* Чтение из CPU memory map */
-u8 Core::Memory::read(u16 addr) const {
+u8 Core::Memory::readBus(u16 addr) const {
     /* 0x0000-0x1FFF: RAM */
     if (addr < 0x2000) {
         return state.ram[addr & MIRROR];
@@ -13,6 +70,7 @@ u8 Core::Memory::read(u16 addr) const {
         if (!ppu) {
             return 0;
         }
+        syncBus();
         return ppu->readReg(addr);
     }
 
@@ -24,6 +82,7 @@ u8 Core::Memory::read(u16 addr) const {
             if (!apu) {
                 return 0;
             }
+            syncBus();
             return apu->readStatus();
 
         /* Контроллер 1 */
@@ -76,7 +135,10 @@ u8 Core::Memory::read(u16 addr) const {
 }
 
 /* Запись в CPU memory map */
-void Core::Memory::write(u16 addr, u8 value) {
+void Core::Memory::writeSlow(u16 addr, u8 value) {
+    if (watched[addr >> 8] && onWatch)
+        onWatch(addr, value, true);
+
     /* 0x0000-0x1FFF: RAM */
     if (addr < 0x2000) {
         state.ram[addr & MIRROR] = value;
@@ -88,12 +150,16 @@ void Core::Memory::write(u16 addr, u8 value) {
         if (!ppu) {
             return;
         }
+        syncBus();
         ppu->writeReg(addr, value);
         return;
     }
 
     /* 0x4000-0x401F: APU / I/O / DMA */
     if (addr < 0x4020) {
+        if (addr <= 0x4017)
+            syncBus();
+
         switch (addr) {
         /* APU регистры */
         case 0x4000:
@@ -172,6 +238,10 @@ void Core::Memory::write(u16 addr, u8 value) {
         if (!mapper) {
             return;
         }
+        /* Банки CHR, mirroring и IRQ маппера видны PPU. Банки PRG
+         * маппер переключает через Cartridge::mapPRG, и страницы
+         * пересобираются только у изменившихся окон */
+        syncBus();
         mapper->writePRG(addr, value);
         return;
     }
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <array>
+#include <functional>
 
 #include "core/mapper.h"
 #include "core/ppu.h"
+#include "core/scheduler.h"
 
 namespace Core {
 class APU;
@@ -17,15 +19,66 @@ public:
     explicit Memory(Mapper *m = nullptr, PPU *p = nullptr, APU *a = nullptr)
         : mapper(m), ppu(p), apu(a) {
         state.ram.fill(0);
+        if (mapper) {
+            mapper->onStorageChanged = [this] { remap(); };
+            mapper->onPRGMapped = [this](u8 slot) { remapPRG(slot); };
+        }
+        remap();
     }
-    ~Memory() = default;
+    ~Memory() {
+        if (mapper) {
+            mapper->onStorageChanged = nullptr;
+            mapper->onPRGMapped = nullptr;
+        }
+    }
+
+    Memory(const Memory &) = delete;
+    auto operator=(const Memory &) -> Memory & = delete;
+
+    /* RAM и отображённые страницы PRG читаются напрямую по таблице,
+     * остальное (регистры, Lua-маппер, watchpoint) - через обработчик */
+    inline u8 read(u16 addr) const {
+        if (const u8 *page = readPages[addr >> 8])
+            return page[addr & 0xFF];
+        return readSlow(addr);
+    }
+    inline void write(u16 addr, u8 value) {
+        if (u8 *page = writePages[addr >> 8]) {
+            page[addr & 0xFF] = value;
+            return;
+        }
+        writeSlow(addr, value);
+    }
+
+    /* Пересборка таблицы страниц (после замены памяти картриджа) */
+    void remap();
+    /* Страницы одного окна PRG по 8 КБ (после смены его банка) */
+    void remapPRG(u8 slot);
 
-    u8 read(u16 addr) const;
-    void write(u16 addr, u8 value);
+    /* Обращения со стороны CPU: каждое занимает один такт шины */
+    inline u8 cpuRead(u16 addr) const {
+        if (scheduler)
+            scheduler->busAccess();
+        return read(addr);
+    }
+    inline void cpuWrite(u16 addr, u8 value) {
+        if (scheduler)
+            scheduler->busAccess();
+        write(addr, value);
+    }
 
 public:
     bool debug{false};
 
+    /* Watchpoint на страницу $XX00-$XXFF: её обращения идут через
+     * обработчик и вызывают onWatch(addr, value, write) */
+    std::function<void(u16, u8, bool)> onWatch;
+
+    void setWatch(u8 page, bool enable) {
+        watched[page] = enable;
+        remap();
+    }
+
 public:
     struct State {
         std::array<u8, 2048> ram{}; /* 0x0000-0x07FF */
@@ -39,7 +92,10 @@ public:
     };
 
     const State &getState() const { return state; }
-    void loadState(const State &s) { state = s; }
+    void loadState(const State &s) {
+        state = s;
+        remap();
+    }
 
 public:
     void setJoy1(u8 s) { state.joy1 = s; }
@@ -61,7 +117,24 @@ public:
     Mapper *mapper{nullptr};
     PPU *ppu{nullptr};
     APU *apu{nullptr};
+    Scheduler *scheduler{nullptr};
     mutable State state{};
+
+private:
+    u8 readSlow(u16 addr) const;
+    u8 readBus(u16 addr) const;
+    void writeSlow(u16 addr, u8 value);
+
+    /* Страницы по 256 байт; nullptr - обращение через обработчик */
+    std::array<const u8 *, 256> readPages{};
+    std::array<u8 *, 256> writePages{};
+    std::array<bool, 256> watched{};
+
+    /* Перед обращением к PPU/APU/мапперу догоняем их до текущего такта */
+    inline void syncBus() const {
+        if (scheduler)
+            scheduler->syncBus();
+    }
 };
 
 } /* namespace Core */
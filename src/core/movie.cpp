@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "common/hash.h"
+
+#include "core/movie.h"
+
+#include "core/console.h"
+
+namespace {
+/* Файл: "NMV", 0x1A, версия, начало, регион, резерв, u64 хэш ROM,
+ * u32 число кадров, u32 размер снимка и сам снимок (только SNAPSHOT),
+ * затем ввод сериями: длина (varint, 7 бит на байт), joy1, joy2.
+ * Кнопки держат много кадров подряд, так что час игры - десятки КБ.
+ * Числа little-endian */
+constexpr u8 MAGIC[4] = {'N', 'M', 'V', 0x1A};
+constexpr u8 VERSION = 1;
+constexpr u32 MAX_FRAMES = 0x7FFFFFFFu;
+
+void putU32(std::vector<u8> &out, u32 v) {
+    for (u32 i = 0; i < 4; ++i)
+        out.push_back(static_cast<u8>(v >> (i * 8)));
+}
+
+void putU64(std::vector<u8> &out, u64 v) {
+    putU32(out, static_cast<u32>(v));
+    putU32(out, static_cast<u32>(v >> 32));
+}
+
+void putVarint(std::vector<u8> &out, u32 v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<u8>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<u8>(v));
+}
+
+/* Чтение с проверкой границ: обрезанный файл - ошибка, а не мусор */
+struct Reader {
+    const std::vector<u8> &data;
+    sz pos{0};
+
+    void need(sz n) const {
+        if (data.size() - pos < n)
+            throw std::runtime_error("[MOVIE]: Файл записи обрезан");
+    }
+
+    auto u8At() -> u8 {
+        need(1);
+        return data[pos++];
+    }
+
+    auto u32At() -> u32 {
+        need(4);
+        u32 v = 0;
+        for (u32 i = 0; i < 4; ++i)
+            v |= static_cast<u32>(data[pos++]) << (i * 8);
+        return v;
+    }
+
+    auto u64At() -> u64 {
+        const u64 lo = u32At();
+        return lo | (static_cast<u64>(u32At()) << 32);
+    }
+
+    auto varint() -> u32 {
+        u32 v = 0;
+        for (u32 shift = 0; shift < 32; shift += 7) {
+            const u8 b = u8At();
+            v |= static_cast<u32>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+                return v;
+        }
+        throw std::runtime_error("[MOVIE]: Неверная длина серии");
+    }
+};
+
+auto readFile(const std::filesystem::path &path) -> std::vector<u8> {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("[MOVIE]: Не удалось открыть " +
+                                 path.string());
+
+    return std::vector<u8>(std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>());
+}
+} /* namespace */
+
+void Core::Movie::startRecording(Console &console, Start from, u64 hash) {
+    if (!console.isLoaded())
+        throw std::runtime_error("[MOVIE]: ROM не загружен");
+    if (from == Start::POWER_ON && console.getFrameCount() != 0)
+        throw std::runtime_error(
+            "[MOVIE]: Запись с включения - только сразу после загрузки ROM");
+
+    start = from;
+    region = console.getRegion();
+    romHash = hash;
+
+    snapshot.clear();
+    if (start == Start::SNAPSHOT)
+        console.saveSnapshot(snapshot);
+
+    inputs.clear();
+    position = 0;
+}
+
+void Core::Movie::record(u8 joy1, u8 joy2) {
+    inputs.push_back(joy1);
+    inputs.push_back(joy2);
+}
+
+void Core::Movie::save(const std::filesystem::path &path) const {
+    if (frames() > MAX_FRAMES)
+        throw std::runtime_error("[MOVIE]: Слишком длинная запись");
+
+    std::vector<u8> out;
+    out.insert(out.end(), std::begin(MAGIC), std::end(MAGIC));
+    out.push_back(VERSION);
+    out.push_back(static_cast<u8>(start));
+    out.push_back(static_cast<u8>(region));
+    out.push_back(0);
+    putU64(out, romHash);
+    putU32(out, static_cast<u32>(frames()));
+    putU32(out, static_cast<u32>(snapshot.size()));
+    out.insert(out.end(), snapshot.begin(), snapshot.end());
+
+    for (sz i = 0; i < inputs.size();) {
+        sz j = i + 2;
+        while (j < inputs.size() && inputs[j] == inputs[i] &&
+               inputs[j + 1] == inputs[i + 1])
+            j += 2;
+
+        putVarint(out, static_cast<u32>((j - i) / 2));
+        out.push_back(inputs[i]);
+        out.push_back(inputs[i + 1]);
+        i = j;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(out.data()),
+               static_cast<std::streamsize>(out.size()));
+    if (!file)
+        throw std::runtime_error("[MOVIE]: Не удалось записать " +
+                                 path.string());
+}
+
+void Core::Movie::load(const std::filesystem::path &path) {
+    const std::vector<u8> data = readFile(path);
+    Reader in{data};
+
+    in.need(sizeof(MAGIC));
+    if (!std::equal(std::begin(MAGIC), std::end(MAGIC), data.begin()))
+        throw std::runtime_error("[MOVIE]: Это не файл записи");
+    in.pos = sizeof(MAGIC);
+
+    if (in.u8At() != VERSION)
+        throw std::runtime_error("[MOVIE]: Неподдерживаемая версия записи");
+
+    const u8 from = in.u8At();
+    const u8 reg = in.u8At();
+    in.u8At();
+    if (from > static_cast<u8>(Start::SNAPSHOT) ||
+        reg > static_cast<u8>(PPU::Region::DENDY))
+        throw std::runtime_error("[MOVIE]: Неверный заголовок записи");
+
+    const u64 hash = in.u64At();
+    const u32 count = in.u32At();
+    const u32 snapshotSize = in.u32At();
+    if (count > MAX_FRAMES)
+        throw std::runtime_error("[MOVIE]: Неверный заголовок записи");
+
+    in.need(snapshotSize);
+    std::vector<u8> snap(data.begin() + static_cast<std::ptrdiff_t>(in.pos),
+                         data.begin() + static_cast<std::ptrdiff_t>(
+                                            in.pos + snapshotSize));
+    in.pos += snapshotSize;
+
+    std::vector<u8> input;
+    input.reserve(static_cast<sz>(count) * 2);
+    while (input.size() < static_cast<sz>(count) * 2) {
+        const u32 run = in.varint();
+        const u8 joy1 = in.u8At();
+        const u8 joy2 = in.u8At();
+        if (run == 0 || run > count - input.size() / 2)
+            throw std::runtime_error("[MOVIE]: Неверная длина серии");
+
+        for (u32 i = 0; i < run; ++i) {
+            input.push_back(joy1);
+            input.push_back(joy2);
+        }
+    }
+
+    start = static_cast<Start>(from);
+    region = static_cast<PPU::Region>(reg);
+    romHash = hash;
+    snapshot = std::move(snap);
+    inputs = std::move(input);
+    position = 0;
+}
+
+void Core::Movie::startPlayback(Console &console) {
+    if (!console.isLoaded())
+        throw std::runtime_error("[MOVIE]: ROM не загружен");
+
+    if (start == Start::POWER_ON && console.getFrameCount() != 0)
+        throw std::runtime_error("[MOVIE]: Запись с включения - проигрывать "
+                                 "сразу после загрузки ROM");
+
+    /* Снимок сам переключает регион на свой; с включения регион берётся
+     * из заголовка */
+    if (start == Start::SNAPSHOT)
+        console.loadSnapshot(snapshot);
+    else
+        console.setRegion(region);
+
+    position = 0;
+}
+
+bool Core::Movie::next(u8 &joy1, u8 &joy2) {
+    if (finished())
+        return false;
+
+    joy1 = inputs[position * 2];
+    joy2 = inputs[position * 2 + 1];
+    ++position;
+    return true;
+}
+
+auto Core::Movie::hashRom(const std::filesystem::path &romPath) -> u64 {
+    const std::vector<u8> data = readFile(romPath);
+    return Common::Hash::xxh64(data.data(), data.size());
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "common/types.h"
+
+#include "core/ppu.h"
+
+namespace Core {
+class Console;
+
+/* Запись ввода: байты обоих джойпадов на каждый кадр. Эмуляция
+ * детерминирована, так что ROM, начальное состояние и ввод однозначно
+ * задают все кадры: запись из отчёта об ошибке воспроизводится один в один,
+ * а headless проигрывает её без ожидания кадров.
+ * Начало - включение консоли (сразу после загрузки ROM) или снимок
+ * состояния, который тогда лежит в самом файле.
+ */
+class Movie {
+public:
+    enum class Start : u8 {
+        POWER_ON = 0,
+        SNAPSHOT = 1,
+    };
+
+public:
+    explicit Movie() = default;
+    ~Movie() = default;
+
+    /* Новая запись с текущего состояния консоли. POWER_ON - только до
+     * первого кадра. romHash - hashRom() файла ROM, для проверки при
+     * проигрывании */
+    void startRecording(Console &console, Start start, u64 romHash);
+
+    /* Ввод очередного кадра (до runFrame) */
+    void record(u8 joy1, u8 joy2);
+
+    void save(const std::filesystem::path &path) const;
+    void load(const std::filesystem::path &path);
+
+    /* Привести консоль к началу записи: регион и, для SNAPSHOT, снимок.
+     * Для POWER_ON консоль должна быть только что загружена тем же ROM */
+    void startPlayback(Console &console);
+
+    /* Ввод следующего кадра; false - запись кончилась */
+    bool next(u8 &joy1, u8 &joy2);
+
+    bool finished() const { return position >= frames(); }
+
+    u64 frames() const { return inputs.size() / 2; }
+    u64 getPosition() const { return position; }
+    Start getStart() const { return start; }
+    PPU::Region getRegion() const { return region; }
+    u64 getRomHash() const { return romHash; }
+
+    /* xxh64 файла ROM целиком */
+    static auto hashRom(const std::filesystem::path &romPath) -> u64;
+
+private:
+    Start start{Start::POWER_ON};
+    PPU::Region region{PPU::Region::NTSC};
+    u64 romHash{0};
+
+    std::vector<u8> snapshot;
+    std::vector<u8> inputs; /* joy1, joy2 на кадр */
+    u64 position{0};
+};
+
+} /* namespace Core */
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "core/netplay.h"
+
+#include "core/console.h"
+#include "core/transport.h"
+
+namespace {
+/* Пакет ввода: "NP", версия, резерв, первый кадр, подтверждение (чужой
+ * ввод известен до этого кадра), кадр и хэш последней проверки
+ * состояния, число байт ввода и сами байты (кадры first..first+count-1),
+ * числа little-endian */
+constexpr u8 PACKET_MAGIC0 = 'N';
+constexpr u8 PACKET_MAGIC1 = 'P';
+constexpr u8 PACKET_VERSION = 2;
+constexpr sz PACKET_HEADER = 4 + 4 + 4 + 4 + 8 + 1;
+constexpr u32 NO_CHECK = 0xFFFFFFFFu;
+
+void putU32(std::vector<u8> &out, u32 v) {
+    for (u32 i = 0; i < 4; ++i)
+        out.push_back(static_cast<u8>(v >> (i * 8)));
+}
+
+void putU64(std::vector<u8> &out, u64 v) {
+    putU32(out, static_cast<u32>(v));
+    putU32(out, static_cast<u32>(v >> 32));
+}
+
+auto getU32(const u8 *in) -> u32 {
+    return static_cast<u32>(in[0]) | (static_cast<u32>(in[1]) << 8) |
+           (static_cast<u32>(in[2]) << 16) | (static_cast<u32>(in[3]) << 24);
+}
+
+auto getU64(const u8 *in) -> u64 {
+    return static_cast<u64>(getU32(in)) |
+           (static_cast<u64>(getU32(in + 4)) << 32);
+}
+} /* namespace */
+
+Core::Netplay::Netplay(Console &console, Transport &transport,
+                       const Config &cfg)
+    : console(console), transport(transport), config(cfg) {
+    if (config.localPlayer > 1)
+        throw std::runtime_error("[NETPLAY]: Игрок должен быть 0 или 1");
+    if (config.maxRollback == 0 || config.maxRollback > MAX_ROLLBACK)
+        throw std::runtime_error("[NETPLAY]: Глубина отката 1-" +
+                                 std::to_string(MAX_ROLLBACK));
+    if (config.inputDelay > MAX_INPUT_DELAY)
+        throw std::runtime_error("[NETPLAY]: Задержка ввода 0-" +
+                                 std::to_string(MAX_INPUT_DELAY));
+
+    /* Первые inputDelay кадров у обоих без нажатий */
+    localKnown = config.inputDelay;
+    remoteKnown = config.inputDelay;
+    remoteAck = config.inputDelay;
+    rollbackFrom = current;
+
+    snapshots.resize(config.maxRollback + 1);
+    packet.reserve(PACKET_HEADER + MAX_PACKET_INPUTS);
+}
+
+bool Core::Netplay::advance(u8 localInput) {
+    receiveInputs();
+
+    /* Дальше maxRollback кадров от подтверждённого не уйти: снимка для
+     * отката уже не будет */
+    stalled = current >= remoteKnown + config.maxRollback;
+    if (stalled) {
+        ++stats.stalls;
+        finishCheck();
+        sendInputs();
+        return true;
+    }
+
+    localInputs[(current + config.inputDelay) % HISTORY] = localInput;
+    localKnown = current + config.inputDelay + 1;
+    sendInputs();
+
+    if (rollbackFrom < current) {
+        const u32 depth = static_cast<u32>(current - rollbackFrom);
+        ++stats.rollbacks;
+        stats.resimFrames += depth;
+        stats.maxDepth = std::max(stats.maxDepth, depth);
+
+        console.loadSnapshot(snapshots[rollbackFrom % snapshots.size()],
+                             true);
+        for (u64 f = rollbackFrom; f < current; ++f) {
+            if (!simulate(f, false))
+                return false;
+        }
+        rollbackFrom = current;
+    }
+
+    finishCheck();
+
+    if (!simulate(current, true))
+        return false;
+
+    ++current;
+    rollbackFrom = current;
+    return true;
+}
+
+bool Core::Netplay::simulate(u64 frame, bool presented) {
+    console.saveSnapshot(snapshots[frame % snapshots.size()]);
+
+    const u8 local = (frame < localKnown) ? localInputs[frame % HISTORY] : 0;
+    const u8 remote = remoteInput(frame);
+    predicted[frame % HISTORY] = remote;
+
+    console.setJoy1(config.localPlayer == 0 ? local : remote);
+    console.setJoy2(config.localPlayer == 0 ? remote : local);
+
+    /* Повторные кадры только догоняют состояние: без звука и картинки */
+    const bool ok =
+        presented ? console.runFrame() : console.runFrameMuted(false);
+
+    /* Хэш пока предварительный: кадр ещё может пройти заново */
+    if (ok && frame % CHECK_INTERVAL == 0)
+        pendingCheck = {frame, console.stateHash().combined()};
+    return ok;
+}
+
+/* Чужой ввод известен и отката к кадру уже не будет: последний
+ * посчитанный хэш окончательный */
+void Core::Netplay::finishCheck() {
+    if (pendingCheck.frame == NO_FRAME ||
+        pendingCheck.frame >= remoteKnown ||
+        pendingCheck.frame >= rollbackFrom)
+        return;
+
+    localCheck = pendingCheck;
+    pendingCheck = {};
+    compareChecks();
+}
+
+/* Собеседник шлёт свою последнюю проверку в каждом пакете, а отстаёт
+ * меньше чем на CHECK_INTERVAL кадров, так что хватает последней */
+void Core::Netplay::compareChecks() {
+    if (desynced() || localCheck.frame == NO_FRAME ||
+        localCheck.frame != remoteCheck.frame)
+        return;
+
+    if (localCheck.hash != remoteCheck.hash)
+        desync = localCheck.frame;
+}
+
+auto Core::Netplay::remoteInput(u64 frame) const -> u8 {
+    if (frame < remoteKnown)
+        return remoteInputs[frame % HISTORY];
+
+    /* Предсказание: кнопки держат так же, как в последнем известном */
+    return (remoteKnown > config.inputDelay)
+               ? remoteInputs[(remoteKnown - 1) % HISTORY]
+               : 0;
+}
+
+/* Всё, что собеседник ещё не подтвердил, с самого старого кадра:
+ * потерянный пакет покрывается следующим */
+void Core::Netplay::sendInputs() {
+    const u64 first = remoteAck;
+    const u64 count = std::min<u64>(localKnown - first, MAX_PACKET_INPUTS);
+
+    packet.clear();
+    packet.push_back(PACKET_MAGIC0);
+    packet.push_back(PACKET_MAGIC1);
+    packet.push_back(PACKET_VERSION);
+    packet.push_back(0);
+    putU32(packet, static_cast<u32>(first));
+    putU32(packet, static_cast<u32>(remoteKnown));
+    putU32(packet, (localCheck.frame != NO_FRAME)
+                       ? static_cast<u32>(localCheck.frame)
+                       : NO_CHECK);
+    putU64(packet, localCheck.hash);
+    packet.push_back(static_cast<u8>(count));
+    for (u64 f = first; f < first + count; ++f)
+        packet.push_back(localInputs[f % HISTORY]);
+
+    transport.send(packet.data(), packet.size());
+}
+
+void Core::Netplay::receiveInputs() {
+    std::vector<u8> &in = packet;
+    while (transport.receive(in)) {
+        if (in.size() < PACKET_HEADER || in[0] != PACKET_MAGIC0 ||
+            in[1] != PACKET_MAGIC1 || in[2] != PACKET_VERSION)
+            continue;
+
+        const u64 first = getU32(&in[4]);
+        const u64 ack = getU32(&in[8]);
+        const u32 checkAt = getU32(&in[12]);
+        const u64 count = in[PACKET_HEADER - 1];
+        if (in.size() != PACKET_HEADER + count)
+            continue;
+
+        if (checkAt != NO_CHECK) {
+            remoteCheck = {checkAt, getU64(&in[16])};
+            compareChecks();
+        }
+
+        /* Подтверждение не может обогнать то, что мы отправили */
+        if (ack > remoteAck && ack <= localKnown)
+            remoteAck = ack;
+
+        /* Берём только продолжение известного, без дыр */
+        if (first > remoteKnown)
+            continue;
+
+        for (u64 f = remoteKnown; f < first + count; ++f) {
+            const u8 input = in[PACKET_HEADER + (f - first)];
+            remoteInputs[f % HISTORY] = input;
+
+            /* Кадр уже прошёл с другим предсказанием: откат */
+            if (f < current && predicted[f % HISTORY] != input)
+                rollbackFrom = std::min(rollbackFrom, f);
+        }
+        remoteKnown = std::max(remoteKnown, first + count);
+    }
+}
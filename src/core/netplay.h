@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "common/types.h"
+
+namespace Core {
+class Console;
+class Transport;
+
+/* Игра вдвоём по сети с откатом (rollback).
+ * Каждый кадр сессия шлёт собеседнику свой ввод (байт джойпада) и сразу
+ * эмулирует кадр, подставляя вместо ещё не пришедшего чужого ввода
+ * последний известный. Перед каждым кадром снимается снимок консоли;
+ * когда настоящий ввод расходится с предсказанным, консоль откатывается
+ * к кадру расхождения и заново проходит кадры до текущего без звука и
+ * показа (до maxRollback кадров за один показанный).
+ * Если собеседник отстал больше чем на maxRollback кадров, advance() ждёт:
+ * кадр не эмулируется, пока не придёт ввод.
+ * Обе консоли должны стартовать из одного состояния (тот же ROM и регион,
+ * сразу после загрузки или из одного снимка): эмуляция детерминирована,
+ * так что одинаковый ввод даёт одинаковые кадры. Для проверки стороны
+ * раз в CHECK_INTERVAL окончательных кадров обмениваются
+ * Console::stateHash(); расхождение видно через desynced().
+ */
+class Netplay {
+public:
+    static inline constexpr u32 MAX_ROLLBACK = 8;
+    static inline constexpr u32 MAX_INPUT_DELAY = 8;
+    static inline constexpr u32 CHECK_INTERVAL = 60;
+
+    struct Config {
+        u8 localPlayer{0}; /* 0 - джойпад 1, 1 - джойпад 2 */
+        u32 inputDelay{1}; /* свой ввод действует через столько кадров */
+        u32 maxRollback{MAX_ROLLBACK};
+    };
+
+    struct Stats {
+        u64 rollbacks{0};
+        u64 resimFrames{0}; /* кадров, пройденных заново */
+        u64 stalls{0};      /* вызовов advance(), ждавших собеседника */
+        u32 maxDepth{0};    /* самый глубокий откат */
+    };
+
+public:
+    explicit Netplay(Console &console, Transport &transport,
+                     const Config &config);
+    ~Netplay() = default;
+
+    Netplay(const Netplay &) = delete;
+    auto operator=(const Netplay &) -> Netplay & = delete;
+
+    /* Один показываемый кадр со своим вводом. false - CPU застрял
+     * (как Console::runFrame). Если собеседник отстал, кадр не идёт
+     * (waiting() == true), но ввод и подтверждения всё равно уходят */
+    bool advance(u8 localInput);
+
+    bool waiting() const { return stalled; }
+
+    /* Состояния разошлись (первый замеченный кадр - desyncFrame()) */
+    bool desynced() const { return desync != NO_FRAME; }
+    u64 desyncFrame() const { return desync; }
+
+    /* Следующий эмулируемый кадр и число кадров с известным чужим вводом */
+    u64 frame() const { return current; }
+    u64 confirmedFrame() const { return remoteKnown; }
+
+    const Stats &getStats() const { return stats; }
+
+private:
+    /* Ввод хранится кольцом: разрыв между своим последним вводом и
+     * подтверждённым собеседником ограничен задержкой и глубиной отката */
+    static inline constexpr sz HISTORY = 128;
+    static inline constexpr sz MAX_PACKET_INPUTS = 64;
+    static inline constexpr u64 NO_FRAME = ~0ull;
+
+    /* Хэш состояния после окончательного кадра frame */
+    struct Check {
+        u64 frame{NO_FRAME};
+        u64 hash{0};
+    };
+
+    void sendInputs();
+    void receiveInputs();
+    bool simulate(u64 frame, bool presented);
+
+    auto remoteInput(u64 frame) const -> u8;
+    void finishCheck();
+    void compareChecks();
+
+    Console &console;
+    Transport &transport;
+    Config config;
+
+    std::array<u8, HISTORY> localInputs{};
+    std::array<u8, HISTORY> remoteInputs{};
+    std::array<u8, HISTORY> predicted{}; /* чужой ввод, с которым шёл кадр */
+
+    u64 current{0};     /* следующий кадр */
+    u64 localKnown{0};  /* свой ввод известен для кадров < localKnown */
+    u64 remoteKnown{0}; /* чужой - для кадров < remoteKnown */
+    u64 remoteAck{0};   /* собеседник получил наш ввод до этого кадра */
+    u64 rollbackFrom{0};
+    bool stalled{false};
+
+    Check pendingCheck; /* посчитан, но кадр ещё может откатиться */
+    Check localCheck;  /* последний свой окончательный */
+    Check remoteCheck; /* последний пришедший */
+    u64 desync{NO_FRAME};
+
+    /* Снимок перед кадром f лежит в snapshots[f % size()] */
+    std::vector<std::vector<u8>> snapshots;
+    std::vector<u8> packet;
+
+    Stats stats{};
+};
+
+} /* namespace Core */
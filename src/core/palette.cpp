@@ -0,0 +1,95 @@
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "core/palette.h"
+
+namespace {
+/* Ослабление каналов, не выбранных битами emphasis (как у 2C02) */
+constexpr f64 EMPHASIS_ATTENUATION = 0.816;
+
+auto pack(u32 r, u32 g, u32 b) -> u32 {
+    return 0xFF000000u | (r << 16) | (g << 8) | b;
+}
+} /* namespace */
+
+Core::Palette::Palette() {
+    for (sz i = 0; i < SIZE; ++i)
+        lut[i] = 0xFF000000u | PPU::PALETTE[i % COLORS];
+}
+
+auto Core::Palette::fromRGB(const u8 *rgb, sz size, bool emphasis)
+    -> Palette {
+    Palette pal;
+
+    if (size == SIZE * 3) {
+        for (sz i = 0; i < SIZE; ++i)
+            pal.lut[i] = pack(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        return pal;
+    }
+
+    if (size != COLORS * 3)
+        throw std::runtime_error("[PALETTE]: Ожидается 64 или 512 цветов");
+
+    for (sz e = 0; e < 8; ++e) {
+        /* Биты emphasis PPUMASK: 5 - красный, 6 - зелёный, 7 - синий */
+        const bool emR = emphasis && (e & 0x01);
+        const bool emG = emphasis && (e & 0x02);
+        const bool emB = emphasis && (e & 0x04);
+        const bool any = emR || emG || emB;
+
+        for (sz c = 0; c < COLORS; ++c) {
+            f64 ch[3] = {static_cast<f64>(rgb[c * 3]),
+                         static_cast<f64>(rgb[c * 3 + 1]),
+                         static_cast<f64>(rgb[c * 3 + 2])};
+
+            /* $xE/$xF - чёрный, emphasis на него не действует */
+            if (any && (c & 0x0F) < 0x0E) {
+                if (!emR)
+                    ch[0] *= EMPHASIS_ATTENUATION;
+                if (!emG)
+                    ch[1] *= EMPHASIS_ATTENUATION;
+                if (!emB)
+                    ch[2] *= EMPHASIS_ATTENUATION;
+            }
+
+            pal.lut[e * COLORS + c] = pack(static_cast<u32>(ch[0] + 0.5),
+                                           static_cast<u32>(ch[1] + 0.5),
+                                           static_cast<u32>(ch[2] + 0.5));
+        }
+    }
+
+    return pal;
+}
+
+auto Core::Palette::load(const std::filesystem::path &path, bool emphasis)
+    -> Palette {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("[PALETTE]: Не удалось открыть " +
+                                 path.string());
+
+    const std::vector<u8> data((std::istreambuf_iterator<char>(file)),
+                               std::istreambuf_iterator<char>());
+    return fromRGB(data.data(), data.size(), emphasis);
+}
+
+void Core::Palette::convert(const u16 *in, u32 *out, sz count) const {
+    const u32 *table = lut.data();
+
+    /* По 8 пикселей за итерацию: независимые загрузки из таблицы */
+    sz i = 0;
+    for (; i + 8 <= count; i += 8) {
+        out[i + 0] = table[in[i + 0] & (SIZE - 1)];
+        out[i + 1] = table[in[i + 1] & (SIZE - 1)];
+        out[i + 2] = table[in[i + 2] & (SIZE - 1)];
+        out[i + 3] = table[in[i + 3] & (SIZE - 1)];
+        out[i + 4] = table[in[i + 4] & (SIZE - 1)];
+        out[i + 5] = table[in[i + 5] & (SIZE - 1)];
+        out[i + 6] = table[in[i + 6] & (SIZE - 1)];
+        out[i + 7] = table[in[i + 7] & (SIZE - 1)];
+    }
+    for (; i < count; ++i)
+        out[i] = table[in[i] & (SIZE - 1)];
+}
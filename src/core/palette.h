@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+
+#include "common/types.h"
+
+#include "core/ppu.h"
+
+namespace Core {
+/* Перевод индексного кадра PPU (PPU::indexFrame) в ARGB.
+ * Таблица на все 512 комбинаций цвета и битов emphasis, так что перевод
+ * кадра - один проход поиска по таблице, которая целиком лежит в L1.
+ */
+class Palette {
+public:
+    static inline constexpr sz COLORS = 64;
+    static inline constexpr sz SIZE = COLORS * 8; /* x 8 комбинаций emphasis */
+
+public:
+    /* PPU::PALETTE без emphasis: то же, что ARGB-вывод PPU */
+    explicit Palette();
+    ~Palette() = default;
+
+    /* RGB-тройки: 64 цвета (emphasis считается затемнением остальных
+     * каналов, если emphasis) или готовые 512 цветов */
+    static auto fromRGB(const u8 *rgb, sz size, bool emphasis = true)
+        -> Palette;
+
+    /* Файл .pal (192 или 1536 байт) */
+    static auto load(const std::filesystem::path &path,
+                     bool emphasis = true) -> Palette;
+
+    inline u32 operator[](u16 entry) const { return lut[entry & (SIZE - 1)]; }
+
+    void convert(const u16 *in, u32 *out, sz count) const;
+
+    void convert(const std::array<u16, PPU::WIDTH * PPU::HEIGHT> &in,
+                 std::array<u32, PPU::WIDTH * PPU::HEIGHT> &out) const {
+        convert(in.data(), out.data(), in.size());
+    }
+
+private:
+    std::array<u32, SIZE> lut{};
+};
+
+} /* namespace Core */
@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include "core/ppu.h"
+#include "core/compositor.h"
 #include "core/mapper.h"
 
 /* Регистры PPU (0x2000-0x2007) */
@@ -17,7 +20,7 @@ u8 Core::PPU::R2C02::readReg(u16 addr) {
             vblankWindow ? (state.ppustatus & static_cast<u8>(~0x80))
                          : state.ppustatus);
         const u8 ret =
-            static_cast<u8>((statusRead & 0xE0) | (state.openBus & 0x1F));
+            static_cast<u8>((statusRead & 0xE0) | (openBus() & 0x1F));
         state.ppustatus &= ~0x80;
         state.w = 0;
         updateNmiState();
@@ -43,8 +46,7 @@ u8 Core::PPU::R2C02::readReg(u16 addr) {
             /* Palette read: данные в младших 6 битах,
              * старшие 2 бита от open bus
              */
-            val =
-                static_cast<u8>((readVRAM(a) & 0x3F) | (state.openBus & 0xC0));
+            val = static_cast<u8>((readVRAM(a) & 0x3F) | (openBus() & 0xC0));
             state.dataBuffer = readVRAM(a & 0x2FFF);
         } else {
             val = state.dataBuffer;
@@ -60,7 +62,7 @@ u8 Core::PPU::R2C02::readReg(u16 addr) {
     }
 
     default:
-        return state.openBus;
+        return openBus();
     }
 }
 
@@ -163,7 +165,7 @@ void Core::PPU::R2C02::writeReg(u16 addr, u8 data) {
 
 /* Один пиксельный тик PPU */
 void Core::PPU::R2C02::step() {
-    tickOpenBusDecay();
+    ++dotClock;
 
     if (state.nmiDelay != 0) {
         --state.nmiDelay;
@@ -222,6 +224,172 @@ void Core::PPU::R2C02::step() {
     }
 }
 
+/* Ближайшее событие, видимое CPU: VBlank, отложенный NMI и тик маппера */
+u32 Core::PPU::R2C02::dotsUntilEvent(u32 mapperSteps) const {
+    static constexpr u16 MAPPER_STEP_DOT = 275;
+
+    const u32 frameDots = static_cast<u32>(p->totalScanlines) * DOTS_PER_LINE;
+    const u32 pos = static_cast<u32>(state.scanline) * DOTS_PER_LINE +
+                    static_cast<u32>(state.pixel);
+
+    /* Сколько вызовов step() нужно, чтобы обработать dot target */
+    const auto distance = [&](u16 scanline, u16 dot) {
+        const u32 target =
+            static_cast<u32>(scanline) * DOTS_PER_LINE + static_cast<u32>(dot);
+        return ((target + frameDots - pos) % frameDots) + 1;
+    };
+
+    u32 dots = distance(p->vblankScanline, 1);
+
+    if (state.nmiDelay != 0)
+        dots = std::min<u32>(dots, state.nmiDelay);
+
+    /* Счётчик scanline маппера (MMC3) тикает на видимых строках. До
+     * step(), который может поднять IRQ, строки рисуются целиком, а если
+     * он наступит только в следующем кадре, событием остаётся vblank */
+    if (mapperSteps != 0 && rendering()) {
+        u16 line = state.scanline;
+        if (!visible() || state.pixel > MAPPER_STEP_DOT)
+            line = (state.scanline + 1 < HEIGHT)
+                       ? static_cast<u16>(state.scanline + 1)
+                       : static_cast<u16>(0);
+        if (mapperSteps - 1 < static_cast<u32>(HEIGHT - line)) {
+            line = static_cast<u16>(line + mapperSteps - 1);
+            dots = std::min(dots, distance(line, MAPPER_STEP_DOT));
+        }
+    }
+
+    return dots;
+}
+
+/* Пачка тактов PPU. Внутри пачки CPU не трогает регистры (планировщик
+ * догоняет PPU перед каждым обращением), поэтому строки без отложенного
+ * NMI можно рисовать целиком, а не по одному dot.
+ */
+void Core::PPU::R2C02::run(u64 dots) {
+    while (dots != 0) {
+        if (p->scanlineRenderer && state.pixel == 0 &&
+            dots >= DOTS_PER_LINE && state.nmiDelay == 0) {
+            if (visible()) {
+                renderScanline();
+                dots -= DOTS_PER_LINE;
+                continue;
+            }
+
+            if (!preLine() && state.scanline != p->vblankScanline) {
+                skipScanline();
+                dots -= DOTS_PER_LINE;
+                continue;
+            }
+        }
+
+        step();
+        --dots;
+    }
+}
+
+/* Видимая строка целиком: тот же порядок выборок, что и в step() */
+void Core::PPU::R2C02::renderScanline() {
+    const sz offset = static_cast<sz>(state.scanline) * WIDTH;
+
+    /* Без вывода и палитра не нужна */
+    if (p->skipOutput) {
+        renderScanline<u16>(nullptr, nullptr);
+        return;
+    }
+
+    if (p->indexedOutput) {
+        std::array<u16, 32> entries;
+        for (u8 i = 0; i < entries.size(); ++i)
+            entries[i] = paletteEntry(i);
+        renderScanline(&indexFrame[offset], entries.data());
+        return;
+    }
+
+    std::array<u32, 32> colors;
+    for (u8 i = 0; i < colors.size(); ++i)
+        colors[i] = paletteColor(i);
+    renderScanline(&frame[offset], colors.data());
+}
+
+/* line == nullptr - строка не выводится (PPU::skipOutput) */
+template <typename Pixel>
+void Core::PPU::R2C02::renderScanline(Pixel *line, const Pixel *colors) {
+    if (!rendering()) {
+        if (line)
+            std::fill(line, line + WIDTH, colors[0]);
+    } else {
+        /* dot 1: очистка secondary OAM */
+        state.secOAM.fill(0xFF);
+        state.secOAMAddr = 0;
+        state.primOAMIndex = 0;
+
+        /* dots 1..256: выборка фона потайлово, затем сведение строки.
+         * Внутри строки CPU не пишет в PPU, так что порядок не важен */
+        std::array<u8, WIDTH> bgLine;
+        bgFetchLine(bgLine.data());
+        if (!(state.ppumask & 0x08))
+            bgLine.fill(0);
+
+        /* Спрайты этой строки выбраны на прошлой */
+        static constexpr std::array<u8, WIDTH> NO_SPRITES{};
+        const u8 *sprLine = (state.ppumask & 0x10) ? currentSpriteLine()
+                                                   : NO_SPRITES.data();
+
+        i32 hit;
+        if (line) {
+            std::array<u8, WIDTH> index;
+            hit = Compositor::compose(bgLine.data(), sprLine, state.ppumask,
+                                      index.data());
+            for (u16 x = 0; x < WIDTH; ++x)
+                line[x] = colors[index[x]];
+        } else {
+            hit = Compositor::sprite0Hit(sprLine, state.ppumask);
+        }
+        if (hit >= 0)
+            state.ppustatus |= 0x40;
+
+        /* dot 256: спрайты следующей строки */
+        state.pixel = 256;
+        evalSprites();
+        state.spriteEvalDone = 1;
+        incrementY();
+
+        /* dot 257: последний сдвиг фона и перезагрузка X */
+        state.pixel = 257;
+        bgFetchTick();
+        reloadX();
+
+        /* dots 257..320: выборка спрайтов (и тик маппера в слоте 2) */
+        for (u8 slot = 0; slot < 8; ++slot) {
+            if (p->mapper && slot == 2)
+                p->mapper->step();
+            if (slot < state.spriteCount)
+                spriteFetch(state.OAM[slot]);
+        }
+        buildSpriteLine();
+
+        /* dots 321..340: предвыборка двух тайлов следующей строки */
+        for (u16 dot = 321; dot < DOTS_PER_LINE; ++dot) {
+            state.pixel = dot;
+            bgFetchTick();
+        }
+    }
+
+    dotClock += DOTS_PER_LINE;
+    state.pixel = 0;
+    ++state.scanline;
+}
+
+/* Невидимая строка без событий: только время идёт */
+void Core::PPU::R2C02::skipScanline() {
+    dotClock += DOTS_PER_LINE;
+    if (++state.scanline >= p->totalScanlines) {
+        state.scanline = 0;
+        state.oddFrame = !state.oddFrame;
+    }
+}
+
 void Core::PPU::R2C02::updateNmiState(bool delayVblank) {
     const bool newNmi = state.nmiOutput && ((state.ppustatus & 0x80) != 0);
     const bool ris = !state.nmiLine && newNmi;
@@ -258,24 +426,51 @@ void Core::PPU::R2C02::refreshOpenBus(u8 value, u8 mask) {
     const u32 decayTicks =
         p->oddFrameDotSkip ? OPENBUS_DECAY_TICKS_NTSC : OPENBUS_DECAY_TICKS_PAL;
 
-    state.openBus = static_cast<u8>((state.openBus & static_cast<u8>(~mask)) |
-                                    (value & mask));
+    /* Незатухшие биты вне mask остаются: досчитываем их до записи */
+    const u8 kept = static_cast<u8>(openBus() & ~mask);
+    state.openBus = static_cast<u8>(kept | (value & mask));
+
+    const u64 deadline = dotClock + decayTicks;
+    if (mask == 0xFF) {
+        openBusDeadline.fill(deadline);
+        return;
+    }
+
     for (u8 bit = 0; bit < 8; ++bit) {
-        const u8 bitMask = static_cast<u8>(1u << bit);
-        if (mask & bitMask)
-            state.openBusDecay[bit] = decayTicks;
+        if (mask & (1u << bit))
+            openBusDeadline[bit] = deadline;
     }
 }
 
-void Core::PPU::R2C02::tickOpenBusDecay() {
+/* Текущее значение open bus: биты, чей срок вышел, обнуляются */
+u8 Core::PPU::R2C02::openBus() {
+    if (state.openBus == 0)
+        return 0;
+
     for (u8 bit = 0; bit < 8; ++bit) {
-        auto &t = state.openBusDecay[bit];
-        if (t == 0)
-            continue;
-        --t;
-        if (t == 0)
+        if (dotClock >= openBusDeadline[bit])
             state.openBus &= static_cast<u8>(~(1u << bit));
     }
+    return state.openBus;
+}
+
+void Core::PPU::R2C02::syncOpenBus() {
+    openBus();
+
+    for (u8 bit = 0; bit < 8; ++bit) {
+        const u64 deadline = openBusDeadline[bit];
+        state.openBusDecay[bit] =
+            (deadline == NO_DECAY || deadline <= dotClock)
+                ? 0
+                : static_cast<u32>(deadline - dotClock);
+    }
+}
+
+void Core::PPU::R2C02::restoreOpenBus() {
+    for (u8 bit = 0; bit < 8; ++bit) {
+        const u32 left = state.openBusDecay[bit];
+        openBusDeadline[bit] = (left == 0) ? NO_DECAY : dotClock + left;
+    }
 }
 
 /* dot выборка фона */
@@ -362,6 +557,107 @@ void Core::PPU::R2C02::bgFetchTick() {
     }
 }
 
+/* dots 1..256 выборки фона за раз, по тайлу на 8 dot: состояние
+ * конвейера в конце то же, что после bgFetchTick() на каждом dot.
+ * В bgLine - пиксели фона строки: биты 0-1 пиксель, 2-3 палитра.
+ * Регистры сдвига ведутся и в упакованном виде (по 2 бита на пиксель,
+ * как Cartridge::CHRRow): 16 пикселей в одном u32 */
+void Core::PPU::R2C02::bgFetchLine(u8 *bgLine) {
+    auto &bg = state.bgFetch;
+    const bool cached = p->mapper && p->mapper->chrRowCached();
+    const u16 table = (state.ppuctrl & 0x10) ? 0x1000 : 0x0000;
+
+    const auto pack16 = [](u16 lo, u16 hi) {
+        return (static_cast<u32>(Cartridge::packRow(
+                    static_cast<u8>(lo >> 8), static_cast<u8>(hi >> 8)))
+                << 16) |
+               Cartridge::packRow(static_cast<u8>(lo), static_cast<u8>(hi));
+    };
+    u32 pixels = pack16(bg.shLow, bg.shHigh);
+    u32 attrs = pack16(bg.shAttrLo, bg.shAttrHi);
+
+    for (u8 tile = 0; tile < WIDTH / 8; ++tile) {
+        /* Сдвиг на dot 1 не делается: пиксели 0 и 1 берут один бит,
+         * а до первой загрузки (dot 8) сдвигов 7, а не 8 */
+        for (u8 i = 0; i < 8; ++i) {
+            const u8 shifts = (tile != 0) ? i : static_cast<u8>(i ? i - 1 : 0);
+            const u8 pos = static_cast<u8>(30 - 2 * (state.fineX + shifts));
+            bgLine[tile * 8 + i] = static_cast<u8>(
+                ((pixels >> pos) & 0x03) | (((attrs >> pos) & 0x03) << 2));
+        }
+
+        /* NT, AT и pattern: тот же порядок чтений, что по dot */
+        bg.nt = readVRAM(static_cast<u16>(0x2000 | (state.v & 0x0FFF)));
+        bg.at = readVRAM(static_cast<u16>(0x23C0 | (state.v & 0x0C00) |
+                                          ((state.v >> 4) & 0x38) |
+                                          ((state.v >> 2) & 0x07)));
+
+        const u16 fineY = static_cast<u16>((state.v >> 12) & 0x07);
+        const u16 pat = static_cast<u16>(table + bg.nt * 16 + fineY);
+        u16 row;
+        if (cached) {
+            const Cartridge::CHRRow r = p->mapper->readCHRRow(pat);
+            bg.low = r.low;
+            bg.high = r.high;
+            row = r.pixels;
+        } else {
+            bg.low = readVRAM(pat);
+            bg.high = readVRAM(static_cast<u16>(pat + 8));
+            row = Cartridge::packRow(bg.low, bg.high);
+        }
+
+        /* Сдвиги до загрузки и сама загрузка (dot 8 тайла) */
+        const u8 n = (tile != 0) ? 8 : 7;
+        const u8 shift =
+            static_cast<u8>(((state.v >> 4) & 0x04) | (state.v & 0x02));
+        const u8 palBits = static_cast<u8>((bg.at >> shift) & 0x03);
+        const u16 attrLo = (palBits & 0x01) ? 0x00FF : 0x0000;
+        const u16 attrHi = (palBits & 0x02) ? 0x00FF : 0x0000;
+
+        bg.shLow = static_cast<u16>(((bg.shLow << n) & 0xFF00) | bg.low);
+        bg.shHigh = static_cast<u16>(((bg.shHigh << n) & 0xFF00) | bg.high);
+        bg.shAttrLo = static_cast<u16>(((bg.shAttrLo << n) & 0xFF00) | attrLo);
+        bg.shAttrHi = static_cast<u16>(((bg.shAttrHi << n) & 0xFF00) | attrHi);
+
+        pixels = ((pixels << (2 * n)) & 0xFFFF0000u) | row;
+        attrs = ((attrs << (2 * n)) & 0xFFFF0000u) |
+                static_cast<u32>(palBits * 0x5555u);
+
+        if (tile != WIDTH / 8 - 1)
+            state.v = incrementX(state.v);
+    }
+}
+
+/* Спрайты строки из secondary OAM в формате Compositor: передний
+ * непрозрачный пиксель (первый в OAM), палитра, приоритет и флаг
+ * непрозрачного пикселя спрайта 0 (он может быть и не передним).
+ * PPUMASK не учитывается: спрайты гасятся при сведении */
+void Core::PPU::R2C02::buildSpriteLine() {
+    spriteLine.fill(0);
+    spriteLineValid = true;
+
+    /* С конца: более приоритетный спрайт пишется поверх */
+    for (u8 i = state.spriteCount; i-- > 0;) {
+        const auto &spr = state.OAM[i];
+        const bool flipH = (spr.attr & 0x40) != 0;
+        const u8 attr = static_cast<u8>(((spr.attr & 0x03) << 2) |
+                                        ((spr.attr & 0x20) >> 1));
+
+        for (u8 dx = 0; dx < 8 && spr.x + dx < WIDTH; ++dx) {
+            const u8 bit = flipH ? dx : static_cast<u8>(7 - dx);
+            const u8 px = static_cast<u8>(((spr.low >> bit) & 0x01) |
+                                          (((spr.high >> bit) & 0x01) << 1));
+            if (px == 0)
+                continue;
+
+            u8 &out = spriteLine[spr.x + dx];
+            out = static_cast<u8>((out & 0x20) | attr | px);
+            if (spr.id == 0)
+                out |= 0x20;
+        }
+    }
+}
+
 /* dot тайминги спрайтовой части */
 void Core::PPU::R2C02::spriteTimingTick() {
     if (state.pixel == 1) {
@@ -390,42 +686,64 @@ void Core::PPU::R2C02::spriteTimingTick() {
         if (p->mapper && visible() && rendering() && slot == 2 && phase == 2)
             p->mapper->step();
 
-        if (slot < state.spriteCount) {
+        /* По dot плоскости читаются раздельно: между ними CPU может
+         * переключить банк */
+        if (slot < state.spriteCount && (phase == 4 || phase == 6)) {
             auto &entry = state.OAM[slot];
-            const u16 height = (state.ppuctrl & 0x20) ? 16 : 8;
-            const u16 nextScanline =
-                static_cast<u16>((state.scanline + 1) % p->totalScanlines);
-
-            u8 fineY = static_cast<u8>(nextScanline - entry.y);
-            if ((entry.attr & 0x80) != 0)
-                fineY = static_cast<u8>(height - 1 - fineY);
-
-            if (phase == 4 || phase == 6) {
-                u16 patAddr;
-                if (height == 16) {
-                    const u16 bank = (entry.tile & 1) ? 0x1000 : 0x0000;
-                    const u16 tileIndex = static_cast<u16>(
-                        (entry.tile & 0xFE) + ((fineY >= 8) ? 1 : 0));
-                    const u8 row = fineY & 7;
-                    patAddr = static_cast<u16>(bank + tileIndex * 16 + row);
-                } else {
-                    const u16 bank = (state.ppuctrl & 0x08) ? 0x1000 : 0x0000;
-                    patAddr = static_cast<u16>(bank + entry.tile * 16 + fineY);
-                }
-
-                if (phase == 4) {
-                    entry.low = readVRAM(patAddr);
-                } else {
-                    entry.high = readVRAM(static_cast<u16>(patAddr + 8));
-                }
-            }
+            const u16 patAddr = spritePatternAddr(entry);
+            if (phase == 4)
+                entry.low = readVRAM(patAddr);
+            else
+                entry.high = readVRAM(static_cast<u16>(patAddr + 8));
+            spriteLineValid = false;
         }
+
+        /* Выборка закончена: строка спрайтов для следующей scanline */
+        if (state.pixel == 320)
+            buildSpriteLine();
     }
 }
 
+/* Адрес плоскости low строки спрайта на следующей scanline */
+u16 Core::PPU::R2C02::spritePatternAddr(const State::SpriteData &entry) const {
+    const u16 height = (state.ppuctrl & 0x20) ? 16 : 8;
+    const u16 nextScanline =
+        static_cast<u16>((state.scanline + 1) % p->totalScanlines);
+
+    u8 fineY = static_cast<u8>(nextScanline - entry.y);
+    if ((entry.attr & 0x80) != 0)
+        fineY = static_cast<u8>(height - 1 - fineY);
+
+    if (height == 16) {
+        const u16 bank = (entry.tile & 1) ? 0x1000 : 0x0000;
+        const u16 tileIndex =
+            static_cast<u16>((entry.tile & 0xFE) + ((fineY >= 8) ? 1 : 0));
+        const u8 row = fineY & 7;
+        return static_cast<u16>(bank + tileIndex * 16 + row);
+    }
+
+    const u16 bank = (state.ppuctrl & 0x08) ? 0x1000 : 0x0000;
+    return static_cast<u16>(bank + entry.tile * 16 + fineY);
+}
+
+/* Обе плоскости строки спрайта (строка целиком, без CPU между ними) */
+void Core::PPU::R2C02::spriteFetch(State::SpriteData &entry) {
+    const u16 patAddr = spritePatternAddr(entry);
+    if (p->mapper && p->mapper->chrRowCached()) {
+        const Cartridge::CHRRow row = p->mapper->readCHRRow(patAddr);
+        entry.low = row.low;
+        entry.high = row.high;
+        return;
+    }
+
+    entry.low = readVRAM(patAddr);
+    entry.high = readVRAM(static_cast<u16>(patAddr + 8));
+}
+
 /* Выборка до 8 спрайтов следующей scanline */
 void Core::PPU::R2C02::evalSprites() {
     state.spriteCount = 0;
+    spriteLineValid = false;
     bool overflow = 0;
     state.secOAM.fill(0xFF);
     state.secOAMAddr = 0;
@@ -481,19 +799,42 @@ void Core::PPU::R2C02::evalSprites() {
 void Core::PPU::R2C02::renderPixel() {
     const u8 x = static_cast<u8>(state.pixel - 1);
 
-    /* Фон */
+    const sz offset = static_cast<sz>(state.scanline) * WIDTH + x;
+
+    if (p->skipOutput) {
+        if (sprite0Candidate(x))
+            pixelIndex(x);
+        return;
+    }
+
+    if (p->indexedOutput)
+        indexFrame[offset] = paletteEntry(pixelIndex(x));
+    else
+        frame[offset] = paletteColor(pixelIndex(x));
+}
+
+/* Индекс в palette RAM для пикселя x текущей строки (0 = фон) */
+u8 Core::PPU::R2C02::pixelIndex(u8 x) {
     u8 bgPixel = 0;
     u8 bgPal = 0;
     if (state.ppumask & 0x08)
         backgroundPixel(bgPixel, bgPal);
 
-    /* Спрайты */
-    u8 fgPixel = 0;
-    u8 fgPal = 0;
-    u8 fgPrio = 0;
-    bool sprite0 = 0;
-    if (state.ppumask & 0x10)
-        spritePixel(x, fgPixel, fgPal, fgPrio, sprite0);
+    return composePixel(x, static_cast<u8>(bgPixel | (bgPal << 2)));
+}
+
+/* Пиксель фона bg (биты 0-1 пиксель, 2-3 палитра) со спрайтами */
+u8 Core::PPU::R2C02::composePixel(u8 x, u8 bg) {
+    /* Фон */
+    u8 bgPixel = bg & 0x03;
+    const u8 bgPal = static_cast<u8>(bg >> 2);
+
+    /* Спрайты: один байт строки спрайтов */
+    const u8 spr = (state.ppumask & 0x10) ? currentSpriteLine()[x] : 0;
+    u8 fgPixel = spr & 0x03;
+    const u8 fgPal = static_cast<u8>((spr >> 2) & 0x03);
+    const u8 fgPrio = static_cast<u8>((spr >> 4) & 0x01);
+    bool sprite0 = (spr & 0x20) != 0;
 
     /* Left-edge mask: первые 8 пикселей могут принудительно гаситься */
     if (x < 8) {
@@ -523,18 +864,34 @@ void Core::PPU::R2C02::renderPixel() {
             palGroup = static_cast<u8>(fgPal + 4);
         }
 
-    /* Индекс цвета в палитре PPU */
-    u16 paletteAddr = 0x3F00;
-    if (px != 0)
-        paletteAddr = static_cast<u16>(paletteAddr + (palGroup << 2) + px);
+    if (px == 0)
+        return 0;
+    return static_cast<u8>((palGroup << 2) + px);
+}
+
+/* Пиксель x может выставить sprite-0 hit: здесь непрозрачный пиксель
+ * спрайта 0, фон и спрайты включены. Для остальных пикселей
+ * pixelIndex() ничего не меняет */
+bool Core::PPU::R2C02::sprite0Candidate(u8 x) {
+    if ((state.ppumask & 0x18) != 0x18)
+        return false;
 
-    u8 colorIdx = readVRAM(paletteAddr) & 0x3F;
+    return (currentSpriteLine()[x] & 0x20) != 0;
+}
+
+/* Цвет (0-63) и биты emphasis для индекса palette RAM */
+u16 Core::PPU::R2C02::paletteEntry(u8 index) const {
+    u8 colorIdx = readVRAM(static_cast<u16>(0x3F00 + index)) & 0x3F;
     /* Greyscale bit (PPUMASK bit0) */
     if (state.ppumask & 0x01)
         colorIdx &= 0x30;
 
-    frame[static_cast<sz>(state.scanline) * WIDTH + x] =
-        (0xFF000000u | PALETTE[colorIdx]);
+    return static_cast<u16>(colorIdx | ((state.ppumask & 0xE0) << 1));
+}
+
+/* Цвет ARGB для индекса palette RAM */
+u32 Core::PPU::R2C02::paletteColor(u8 index) const {
+    return 0xFF000000u | PALETTE[paletteEntry(index) & 0x3F];
 }
 
 /* Получение пикселя фона */
@@ -549,44 +906,6 @@ void Core::PPU::R2C02::backgroundPixel(u8 &pixel, u8 &pal) {
     pal = static_cast<u8>(a0 | (a1 << 1));
 }
 
-/* Получение front спрайтового пикселя (с учетом OAM) */
-void Core::PPU::R2C02::spritePixel(u8 x, u8 &pixel, u8 &pal, u8 &prio,
-                                   bool &sprite0) {
-    pixel = 0;
-    sprite0 = 0;
-
-    /* Приоритет: первый непрозрачный спрайт в secondary OAM */
-    for (u8 i = 0; i < state.spriteCount; ++i) {
-        const auto &spr = state.OAM[i];
-
-        if (x < spr.x || x >= spr.x + 8)
-            continue;
-        i16 dx = static_cast<i16>(x) - static_cast<i16>(spr.x);
-        if (dx < 0 || dx >= 8)
-            continue;
-
-        /* Горизонтальный флип меняет порядок битов */
-        const bool flipH = (spr.attr & 0x40) != 0;
-        const u8 bit = flipH ? static_cast<u8>(dx) : static_cast<u8>(7 - dx);
-        const u8 sprPixel = static_cast<u8>(((spr.low >> bit) & 1) |
-                                            (((spr.high >> bit) & 0x01) << 1));
-
-        /* Нулевой индекс = прозрачный пиксель спрайта */
-        if (sprPixel == 0)
-            continue;
-
-        if (pixel == 0) {
-            pixel = sprPixel;
-            pal = spr.attr & 0x03;
-            prio = static_cast<u8>((spr.attr >> 5) & 0x01);
-        }
-
-        /* Флаг кандидата для sprite-0 hit */
-        if (spr.id == 0 && sprPixel != 0)
-            sprite0 = 1;
-    }
-}
-
 /* Чтение из пространства PPU 0x0000-0x3FFF */
 u8 Core::PPU::R2C02::readVRAM(u16 addr) const {
     addr &= 0x3FFF;
@@ -632,34 +951,18 @@ void Core::PPU::R2C02::writeVRAM(u16 addr, u8 data) {
     }
 }
 
-/* Преобразование 0x2000-0x2FFF с учетом mirroring */
+/* Преобразование 0x2000-0x2FFF с учетом mirroring: таблицу страниц
+ * перестраивает Cartridge::setMirror() */
 u16 Core::PPU::R2C02::mirrorAddress(u16 addr) const {
-    addr = static_cast<u16>(0x2000 + (addr & 0x0FFF));
+    const u16 page = static_cast<u16>((addr >> 10) & 0x03);
     const u16 offset = addr & 0x03FF;
-    u16 table = static_cast<u16>((addr >> 10) & 0x03);
 
-    const u8 mode =
-        p->mapper ? static_cast<u8>(p->mapper->mirror) : state.mirrorMode;
-    switch (mode) {
-    case Mapper::HORIZONTAL:
-        table = (table < 2) ? 0 : 1;
-        break;
-    case Mapper::VERTICAL:
-        table &= 1;
-        break;
-    case Mapper::SINGLE_DOWN:
-        table = 0;
-        break;
-    case Mapper::SINGLE_UP:
-        table = 1;
-        break;
-    case Mapper::FOUR:
-        break;
-    default:
-        break;
-    }
+    if (p->mapper)
+        return static_cast<u16>(p->mapper->ntMap[page] | offset);
 
-    return static_cast<u16>(table * 0x400 + offset);
+    /* Без маппера (отладка, тесты PPU) - режим из состояния PPU */
+    return static_cast<u16>(Cartridge::mirrorPages(state.mirrorMode)[page] |
+                            offset);
 }
 
 #if defined(DEBUG)
@@ -11,6 +11,7 @@ class PPU {
 public:
     static constexpr u16 WIDTH = 256;
     static constexpr u16 HEIGHT = 240;
+    static constexpr u16 DOTS_PER_LINE = 341;
 
     static constexpr u32 OPENBUS_DECAY_TICKS_NTSC = 5369318;
     static constexpr u32 OPENBUS_DECAY_TICKS_PAL = 5320342;
@@ -40,6 +41,9 @@ public:
 public:
     bool debug{false};
 
+    /* Отрисовка целых строк за проход, когда внутри строки нет событий */
+    bool scanlineRenderer{true};
+
     u8 readReg(u16 addr) { return r.readReg(addr); }
     void writeReg(u16 addr, u8 value) { r.writeReg(addr, value); }
     void step() { r.step(); }
@@ -68,7 +72,8 @@ public:
         bool oddFrame{0}; /* пропуск цикла у нечётных кадров */
         u8 openBus{0};    /* open bus */
         std::array<u32, 8>
-            openBusDecay{};     /* таймеры затухания битов open bus */
+            openBusDecay{};     /* dot до затухания битов open bus (0 - нет);
+                                   в эмуляции - R2C02::openBusDeadline */
         bool nmiOutput{0};      /* выход NMI из PPUCTRL */
         bool suppressVblank{0}; /* подавление VBlank/NMI на edge-case */
 
@@ -116,8 +121,16 @@ public:
         bool spriteEvalDone{0}; /* флаг завершения sprite evaluation */
     } state{};
 
-    State &getState() { return state; }
-    void loadState(const State &s) { state = s; }
+    /* openBus и openBusDecay в state досчитываются только здесь */
+    State &getState() {
+        r.syncOpenBus();
+        return state;
+    }
+    void loadState(const State &s) {
+        state = s;
+        r.restoreOpenBus();
+        r.invalidateSpriteLine();
+    }
 
     void setRegion(Region region) {
         videoMode = region;
@@ -139,8 +152,19 @@ public:
         }
     }
 
+    /* Вывод индексов вместо ARGB: PPU пишет только indexFrame (цвет 0-63
+     * в битах 0-5 и биты emphasis PPUMASK в битах 6-8), а перевод в RGB
+     * делает Core::Palette при показе кадра */
+    bool indexedOutput{false};
+
+    /* Кадр не будет показан (перемотка, повторные кадры отката): пиксели
+     * не пишутся, но выборки, sprite-0 hit и тайминги те же. В frame и
+     * indexFrame остаётся прошлая картинка */
+    bool skipOutput{false};
+
 public:
     std::array<u32, WIDTH * HEIGHT> frame{};
+    std::array<u16, WIDTH * HEIGHT> indexFrame{};
 
 private:
     Mapper *mapper{nullptr};
@@ -156,11 +180,13 @@ public:
     public:
         explicit R2C02(PPU *p)
             : p(p), state(p->state), frame(p->frame),
-              frameReady(p->frameReady) {
+              indexFrame(p->indexFrame), frameReady(p->frameReady) {
+            openBusDeadline.fill(NO_DECAY);
             state.vram.fill(0);
             state.pal.fill(0);
             state.oam.fill(0);
             frame.fill(0);
+            indexFrame.fill(0);
         }
         ~R2C02() = default;
 
@@ -170,6 +196,7 @@ public:
     public:
         State &state;
         std::array<u32, WIDTH * HEIGHT> &frame;
+        std::array<u16, WIDTH * HEIGHT> &indexFrame;
         bool &frameReady;
 
         void setMirror(u8 m) { state.mirrorMode = m; }
@@ -179,9 +206,37 @@ public:
         u8 readReg(u16 addr);
         void writeReg(u16 addr, u8 data);
         void step();
+        void run(u64 dots);
         std::array<u8, 128 * 128> getPttrnTable(u8 table) const;
 
+        /* Сколько dot можно выполнить пачкой до ближайшего события.
+         * mapperSteps - номер step() маппера, который может поднять IRQ
+         * (0 - маппер без step()) */
+        u32 dotsUntilEvent(u32 mapperSteps) const;
+
+        /* Перевод затухания open bus в State::openBusDecay и обратно */
+        void syncOpenBus();
+        void restoreOpenBus();
+
+        /* secondary OAM изменён не выборкой спрайтов (загрузка State) */
+        void invalidateSpriteLine() { spriteLineValid = false; }
+
     private:
+        static inline constexpr u64 NO_DECAY = ~0ull;
+
+        /* Затухание open bus лениво: для каждого бита хранится dot (по
+         * dotClock), на котором он обнулится, а проверяется это только при
+         * чтении open bus, а не на каждом dot */
+        u64 dotClock{0};
+        std::array<u64, 8> openBusDeadline{};
+
+        /* Спрайты строки по байту на пиксель (формат Compositor): строится
+         * в конце выборки спрайтов (dot 320) для следующей строки, так что
+         * пиксель читает один байт вместо обхода secondary OAM. Любое
+         * другое изменение state.OAM сбрасывает spriteLineValid */
+        std::array<u8, WIDTH> spriteLine{};
+        bool spriteLineValid{false};
+
         inline bool rendering() const { return (state.ppumask & 0x18) != 0; }
         inline bool visible() const { return (state.scanline < 240); }
         inline bool preLine() const {
@@ -200,13 +255,30 @@ public:
         u16 mirrorAddress(u16 addr) const;
 
         void renderPixel();
+        void renderScanline();
+        template <typename Pixel>
+        void renderScanline(Pixel *line, const Pixel *colors);
+        void skipScanline();
+        u8 pixelIndex(u8 x);
+        u8 composePixel(u8 x, u8 bg);
+        bool sprite0Candidate(u8 x);
+        u16 paletteEntry(u8 index) const;
+        u32 paletteColor(u8 index) const;
         void backgroundPixel(u8 &pixel, u8 &pal);
-        void spritePixel(u8 x, u8 &pixel, u8 &pal, u8 &prio, bool &sprite0);
         void evalSprites();
         void bgFetchTick();
+        void bgFetchLine(u8 *bgLine);
+        void buildSpriteLine();
+        inline const u8 *currentSpriteLine() {
+            if (!spriteLineValid)
+                buildSpriteLine();
+            return spriteLine.data();
+        }
         void spriteTimingTick();
+        u16 spritePatternAddr(const State::SpriteData &entry) const;
+        void spriteFetch(State::SpriteData &entry);
         void refreshOpenBus(u8 value, u8 mask = 0xFF);
-        void tickOpenBusDecay();
+        u8 openBus();
         void updateNmiState(bool delayVblank = false);
         void incrementVRAMAddr();
 
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "core/rewind.h"
+
+#include "core/console.h"
+
+namespace {
+/* Серия нулей короче этого выгоднее оставить внутри литералов */
+constexpr sz MIN_ZERO_RUN = 4;
+
+void putVarint(std::vector<u8> &out, sz value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<u8>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<u8>(value));
+}
+
+auto getVarint(const std::vector<u8> &in, sz &pos) -> sz {
+    sz value = 0;
+    for (u32 shift = 0; pos < in.size(); shift += 7) {
+        const u8 b = in[pos++];
+        value |= static_cast<sz>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return value;
+    }
+    throw std::runtime_error("[REWIND]: Повреждённый снимок");
+}
+
+void xorInto(std::vector<u8> &dst, const std::vector<u8> &src) {
+    for (sz i = 0; i < dst.size(); ++i)
+        dst[i] ^= src[i];
+}
+} /* namespace */
+
+Core::Rewind::Rewind(sz budget, u32 interval, u32 keyInterval)
+    : budget(budget), interval((interval != 0) ? interval : 1),
+      keyInterval((keyInterval != 0) ? keyInterval : 1) {}
+
+void Core::Rewind::push(Console &console) {
+    if (++frameCounter < interval)
+        return;
+
+    frameCounter = 0;
+    capture(console);
+}
+
+bool Core::Rewind::rewind(Console &console) {
+    if (entries.empty())
+        return false;
+
+    /* Последняя запись всегда относится к последнему ключевому снимку */
+    const Entry &last = entries.back();
+    if (last.key) {
+        current = keyframe;
+    } else {
+        decompress(last.data, current);
+        xorInto(current, keyframe);
+    }
+
+    console.loadSnapshot(current);
+
+    const bool wasKey = last.key;
+    totalBytes -= last.data.size();
+    entries.pop_back();
+    frameCounter = 0;
+
+    if (!wasKey) {
+        --sinceKey;
+        return true;
+    }
+
+    /* Ключевой снимок ушёл: база дельт теперь предыдущий ключевой */
+    keyframe.clear();
+    sinceKey = 0;
+    for (sz i = entries.size(); i-- > 0;) {
+        if (entries[i].key) {
+            decompress(entries[i].data, keyframe);
+            sinceKey = static_cast<u32>(entries.size() - i);
+            break;
+        }
+    }
+
+    return true;
+}
+
+void Core::Rewind::clear() {
+    entries.clear();
+    totalBytes = 0;
+    frameCounter = 0;
+    sinceKey = 0;
+    keyframe.clear();
+}
+
+void Core::Rewind::capture(Console &console) {
+    console.saveSnapshot(current);
+    if (current.empty())
+        return;
+
+    Entry entry;
+    if (keyframe.empty() || sinceKey >= keyInterval ||
+        keyframe.size() != current.size()) {
+        entry.key = true;
+        compress(current, entry.data);
+        keyframe.swap(current);
+        sinceKey = 1;
+    } else {
+        xorInto(current, keyframe);
+        compress(current, entry.data);
+        ++sinceKey;
+    }
+
+    totalBytes += entry.data.size();
+    entries.push_back(std::move(entry));
+    evict();
+}
+
+void Core::Rewind::evict() {
+    while (totalBytes > budget) {
+        /* Группа: ключевой снимок и все его дельты */
+        sz end = 1;
+        while (end < entries.size() && !entries[end].key)
+            ++end;
+
+        /* Последняя группа нужна для следующих дельт */
+        if (end >= entries.size())
+            break;
+
+        for (sz i = 0; i < end; ++i) {
+            totalBytes -= entries.front().data.size();
+            entries.pop_front();
+        }
+    }
+}
+
+void Core::Rewind::compress(const std::vector<u8> &in, std::vector<u8> &out) {
+    out.clear();
+    putVarint(out, in.size());
+
+    /* Серия нулей от p: MIN_ZERO_RUN нулей подряд или нули до конца */
+    const auto zeroRunAt = [&in](sz p) {
+        const sz end = std::min(p + MIN_ZERO_RUN, in.size());
+        for (sz i = p; i < end; ++i)
+            if (in[i] != 0)
+                return false;
+        return true;
+    };
+
+    sz pos = 0;
+    while (pos < in.size()) {
+        const sz zeroStart = pos;
+        while (pos < in.size() && in[pos] == 0)
+            ++pos;
+
+        const sz litStart = pos;
+        while (pos < in.size() && !zeroRunAt(pos))
+            ++pos;
+
+        putVarint(out, litStart - zeroStart);
+        putVarint(out, pos - litStart);
+        out.insert(out.end(),
+                   in.begin() + static_cast<std::ptrdiff_t>(litStart),
+                   in.begin() + static_cast<std::ptrdiff_t>(pos));
+    }
+}
+
+void Core::Rewind::decompress(const std::vector<u8> &in,
+                              std::vector<u8> &out) {
+    sz pos = 0;
+    const sz size = getVarint(in, pos);
+    out.assign(size, 0);
+
+    sz outPos = 0;
+    while (outPos < size) {
+        outPos += getVarint(in, pos);
+        const sz literals = getVarint(in, pos);
+
+        if (outPos + literals > size || in.size() - pos < literals)
+            throw std::runtime_error("[REWIND]: Повреждённый снимок");
+
+        std::copy(in.begin() + static_cast<std::ptrdiff_t>(pos),
+                  in.begin() + static_cast<std::ptrdiff_t>(pos + literals),
+                  out.begin() + static_cast<std::ptrdiff_t>(outPos));
+        pos += literals;
+        outPos += literals;
+    }
+}
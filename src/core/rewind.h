@@ -0,0 +1,71 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "common/types.h"
+
+namespace Core {
+class Console;
+
+/* Кольцо снимков для перемотки назад.
+ * Каждые interval кадров снимается Console::saveSnapshot(). Каждый
+ * keyInterval-й снимок ключевой, остальные хранятся как XOR с последним
+ * ключевым: между соседними кадрами меняется малая часть RAM/VRAM, так что
+ * дельта почти вся из нулей и хорошо жмётся кодированием серий нулей.
+ * Старые группы (ключевой снимок + его дельты) вытесняются целиком,
+ * когда суммарный размер превышает budget.
+ */
+class Rewind {
+public:
+    static inline constexpr sz DEFAULT_BUDGET = 8 * 1024 * 1024;
+    static inline constexpr u32 DEFAULT_INTERVAL = 2;
+    static inline constexpr u32 DEFAULT_KEY_INTERVAL = 60;
+
+public:
+    explicit Rewind(sz budget = DEFAULT_BUDGET,
+                    u32 interval = DEFAULT_INTERVAL,
+                    u32 keyInterval = DEFAULT_KEY_INTERVAL);
+    ~Rewind() = default;
+
+    /* Вызывается после каждого кадра; снимает каждый interval-й */
+    void push(Console &console);
+
+    /* Загрузить последний снимок и убрать его из кольца */
+    bool rewind(Console &console);
+
+    void clear();
+
+    sz size() const { return entries.size(); }
+    sz bytes() const { return totalBytes; }
+    sz getBudget() const { return budget; }
+
+private:
+    struct Entry {
+        std::vector<u8> data; /* сжатый снимок или дельта */
+        bool key{false};
+    };
+
+    /* Серии нулей: [нулей][литералов][литералы...], длины в varint */
+    static void compress(const std::vector<u8> &in, std::vector<u8> &out);
+    static void decompress(const std::vector<u8> &in, std::vector<u8> &out);
+
+    void capture(Console &console);
+    void evict();
+
+    sz budget;
+    u32 interval;
+    u32 keyInterval;
+
+    std::deque<Entry> entries;
+    sz totalBytes{0};
+    u32 frameCounter{0};
+    u32 sinceKey{0};
+
+    /* Рабочие буферы, чтобы не выделять память на каждый снимок */
+    std::vector<u8> keyframe; /* последний ключевой снимок, несжатый */
+    std::vector<u8> current;
+    std::vector<u8> scratch;
+};
+
+} /* namespace Core */
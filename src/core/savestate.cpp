@@ -0,0 +1,279 @@
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "core/savestate.h"
+
+namespace {
+/* Секции копируются как есть */
+static_assert(std::is_trivially_copyable_v<Core::CPU::State>);
+static_assert(std::is_trivially_copyable_v<Core::PPU::State>);
+static_assert(std::is_trivially_copyable_v<Core::APU::State>);
+static_assert(std::is_trivially_copyable_v<Core::Memory::State>);
+
+constexpr auto tag(const char (&s)[5]) -> u32 {
+    return static_cast<u32>(static_cast<u8>(s[0])) |
+           static_cast<u32>(static_cast<u8>(s[1])) << 8 |
+           static_cast<u32>(static_cast<u8>(s[2])) << 16 |
+           static_cast<u32>(static_cast<u8>(s[3])) << 24;
+}
+
+constexpr u32 TAG_CPU = tag("CPU ");
+constexpr u32 TAG_PPU = tag("PPU ");
+constexpr u32 TAG_APU = tag("APU ");
+constexpr u32 TAG_MEM = tag("MEM ");
+constexpr u32 TAG_MAPPER = tag("MAPR"); /* номер, mirroring, IRQ */
+constexpr u32 TAG_PRG_RAM = tag("PRAM");
+constexpr u32 TAG_CHR_RAM = tag("CRAM");
+constexpr u32 TAG_MAPPER_BLOB = tag("MBLB");
+constexpr u32 TAG_CONSOLE = tag("CONS"); /* регион, кадр, такт CPU */
+
+constexpr sz HEADER_SIZE = 3 * sizeof(u32);
+constexpr sz ENTRY_SIZE = 3 * sizeof(u32);
+constexpr u32 MAX_SECTIONS = 64;
+
+struct Section {
+    u32 tag;
+    const void *data;
+    sz size;
+};
+
+struct MapperHeader {
+    u8 mapperNumber;
+    u8 mirrorMode;
+    u8 irqFlag;
+};
+
+struct ConsoleHeader {
+    u64 frameCount;
+    u64 cpuCycle;
+    u8 region;
+};
+
+void putU32(u8 *p, u32 value) { std::memcpy(p, &value, sizeof(value)); }
+
+auto getU32(const u8 *p) -> u32 {
+    u32 value = 0;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/* Поля bool в State-структурах. Байт, отличный от 0 и 1, скопированный
+ * в bool, - неопределённое поведение, так что такая секция отвергается
+ * до копирования. Новое поле bool в State надо добавить и сюда */
+static_assert(sizeof(bool) == 1);
+
+bool boolsValid(const u8 *data, sz base, std::initializer_list<sz> offsets) {
+    for (const sz offset : offsets) {
+        if (data[base + offset] > 1)
+            return false;
+    }
+    return true;
+}
+
+bool boolsValid(const u8 *data, const Core::CPU::State &) {
+    using S = Core::CPU::State;
+    return boolsValid(data, 0,
+                      {offsetof(S, do_nmi), offsetof(S, do_irq),
+                       offsetof(S, page_crossed)});
+}
+
+bool boolsValid(const u8 *data, const Core::PPU::State &) {
+    using S = Core::PPU::State;
+    return boolsValid(data, 0,
+                      {offsetof(S, nmi), offsetof(S, nmiLine),
+                       offsetof(S, oddFrame), offsetof(S, nmiOutput),
+                       offsetof(S, suppressVblank), offsetof(S, bgFetch.valid),
+                       offsetof(S, spriteEvalDone)});
+}
+
+bool boolsValid(const u8 *data, const Core::APU::State &) {
+    using S = Core::APU::State;
+    using Pulse = Core::APU::Pulse;
+    using Triangle = Core::APU::Triangle;
+    using Noise = Core::APU::Noise;
+    using DMC = Core::APU::DMC;
+
+    const std::initializer_list<sz> pulse = {
+        offsetof(Pulse, enabled),    offsetof(Pulse, lengthHalt),
+        offsetof(Pulse, constVol),   offsetof(Pulse, envelStart),
+        offsetof(Pulse, swpEnabled), offsetof(Pulse, swpNegate),
+        offsetof(Pulse, swpReload)};
+
+    return boolsValid(data, offsetof(S, pulse1), pulse) &&
+           boolsValid(data, offsetof(S, pulse2), pulse) &&
+           boolsValid(data, offsetof(S, triangle),
+                      {offsetof(Triangle, enabled),
+                       offsetof(Triangle, ctrlFlag),
+                       offsetof(Triangle, linearReloadFlag)}) &&
+           boolsValid(data, offsetof(S, noise),
+                      {offsetof(Noise, enabled), offsetof(Noise, lenHalt),
+                       offsetof(Noise, constVol), offsetof(Noise, envelStart),
+                       offsetof(Noise, mode)}) &&
+           boolsValid(data, offsetof(S, dmc),
+                      {offsetof(DMC, enabled), offsetof(DMC, irqEnabled),
+                       offsetof(DMC, loop), offsetof(DMC, irqFlag),
+                       offsetof(DMC, bufferEmpty), offsetof(DMC, active)}) &&
+           boolsValid(data, 0,
+                      {offsetof(S, frameCntMode5), offsetof(S, irqInhibit),
+                       offsetof(S, frameIrq), offsetof(S, oddCycle),
+                       offsetof(S, pendQuarterFrame),
+                       offsetof(S, pendHalfFrame),
+                       offsetof(S, delayHalfFrame)});
+}
+
+bool boolsValid(const u8 *data, const Core::Memory::State &) {
+    using S = Core::Memory::State;
+    return boolsValid(data, 0, {offsetof(S, dmaOdd), offsetof(S, joy)});
+}
+
+/* Заголовки секций без bool */
+template <typename T> bool boolsValid(const u8 *, const T &) { return true; }
+
+template <typename T> bool getStruct(const u8 *data, sz size, T &out) {
+    if (size != sizeof(T) || !boolsValid(data, out))
+        return false;
+    std::memcpy(&out, data, sizeof(T));
+    return true;
+}
+
+bool getBytes(const u8 *data, sz size, u32 limit, std::vector<u8> &out) {
+    if (size > limit)
+        return false;
+    out.assign(data, data + size);
+    return true;
+}
+} /* namespace */
+
+void Core::encodeState(const SaveState &state, std::vector<u8> &out) {
+    MapperHeader mapper{};
+    mapper.mapperNumber = state.mapper.mapperNumber;
+    mapper.mirrorMode = state.mapper.mirrorMode;
+    mapper.irqFlag = static_cast<u8>(state.mapper.irqFlag);
+
+    ConsoleHeader console{};
+    console.frameCount = state.frameCount;
+    console.cpuCycle = state.cpuCycle;
+    console.region = state.region;
+
+    const Section sections[] = {
+        {TAG_CONSOLE, &console, sizeof(console)},
+        {TAG_CPU, &state.cpu, sizeof(state.cpu)},
+        {TAG_PPU, &state.ppu, sizeof(state.ppu)},
+        {TAG_APU, &state.apu, sizeof(state.apu)},
+        {TAG_MEM, &state.mem, sizeof(state.mem)},
+        {TAG_MAPPER, &mapper, sizeof(mapper)},
+        {TAG_PRG_RAM, state.mapper.prgRam.data(), state.mapper.prgRam.size()},
+        {TAG_CHR_RAM, state.mapper.chrRam.data(), state.mapper.chrRam.size()},
+        {TAG_MAPPER_BLOB, state.mapper.mapperBlob.data(),
+         state.mapper.mapperBlob.size()},
+    };
+    constexpr u32 count = static_cast<u32>(std::size(sections));
+
+    sz total = HEADER_SIZE + count * ENTRY_SIZE;
+    for (const Section &s : sections)
+        total += s.size;
+
+    out.resize(total);
+    u8 *p = out.data();
+    putU32(p, NES_STATE);
+    putU32(p + 4, NES_STATE_VERSION);
+    putU32(p + 8, count);
+
+    u8 *entry = p + HEADER_SIZE;
+    sz offset = HEADER_SIZE + count * ENTRY_SIZE;
+    for (const Section &s : sections) {
+        putU32(entry, s.tag);
+        putU32(entry + 4, static_cast<u32>(offset));
+        putU32(entry + 8, static_cast<u32>(s.size));
+        entry += ENTRY_SIZE;
+
+        if (s.size != 0)
+            std::memcpy(p + offset, s.data, s.size);
+        offset += s.size;
+    }
+}
+
+auto Core::decodeState(const u8 *data, sz size, SaveState &state) -> bool {
+    if (!data || size < HEADER_SIZE)
+        return false;
+
+    const u32 count = getU32(data + 8);
+    if (getU32(data) != NES_STATE || getU32(data + 4) != NES_STATE_VERSION ||
+        count > MAX_SECTIONS || size < HEADER_SIZE + count * ENTRY_SIZE)
+        return false;
+
+    /* Обязательные секции: CONS, CPU, PPU, APU, MEM, MAPR */
+    u32 found = 0;
+
+    state.mapper.prgRam.clear();
+    state.mapper.chrRam.clear();
+    state.mapper.mapperBlob.clear();
+
+    for (u32 i = 0; i < count; ++i) {
+        const u8 *entry = data + HEADER_SIZE + i * ENTRY_SIZE;
+        const u32 sectionTag = getU32(entry);
+        const sz offset = getU32(entry + 4);
+        const sz length = getU32(entry + 8);
+        if (offset > size || length > size - offset)
+            return false;
+
+        const u8 *p = data + offset;
+        bool ok = true;
+
+        switch (sectionTag) {
+        case TAG_CONSOLE: {
+            ConsoleHeader console{};
+            ok = getStruct(p, length, console);
+            state.frameCount = console.frameCount;
+            state.cpuCycle = console.cpuCycle;
+            state.region = console.region;
+            found |= 1u << 0;
+            break;
+        }
+        case TAG_CPU:
+            ok = getStruct(p, length, state.cpu);
+            found |= 1u << 1;
+            break;
+        case TAG_PPU:
+            ok = getStruct(p, length, state.ppu);
+            found |= 1u << 2;
+            break;
+        case TAG_APU:
+            ok = getStruct(p, length, state.apu);
+            found |= 1u << 3;
+            break;
+        case TAG_MEM:
+            ok = getStruct(p, length, state.mem);
+            found |= 1u << 4;
+            break;
+        case TAG_MAPPER: {
+            MapperHeader mapper{};
+            ok = getStruct(p, length, mapper);
+            state.mapper.mapperNumber = mapper.mapperNumber;
+            state.mapper.mirrorMode = mapper.mirrorMode;
+            state.mapper.irqFlag = mapper.irqFlag != 0;
+            found |= 1u << 5;
+            break;
+        }
+        case TAG_PRG_RAM:
+            ok = getBytes(p, length, MAX_MAPPER_PRG_RAM, state.mapper.prgRam);
+            break;
+        case TAG_CHR_RAM:
+            ok = getBytes(p, length, MAX_MAPPER_CHR_RAM, state.mapper.chrRam);
+            break;
+        case TAG_MAPPER_BLOB:
+            ok = getBytes(p, length, MAX_MAPPER_BLOB, state.mapper.mapperBlob);
+            break;
+        default:
+            break;
+        }
+
+        if (!ok)
+            return false;
+    }
+
+    return found == 0x3F;
+}
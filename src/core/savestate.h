@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+#include "common/types.h"
+
+#include "core/apu.h"
+#include "core/cpu.h"
+#include "core/mapper.h"
+#include "core/mem.h"
+#include "core/ppu.h"
+
+namespace Core {
+inline constexpr u32 NES_STATE = 0x4E5354; /* NST */
+inline constexpr u32 MIN_NES_STATE_VERSION = 2;
+inline constexpr u32 NES_STATE_VERSION = 4; /* 2, 3 - потоковый формат */
+
+inline constexpr u32 MAX_MAPPER_PRG_RAM = 16 * 1024 * 1024;
+inline constexpr u32 MAX_MAPPER_CHR_RAM = 16 * 1024 * 1024;
+inline constexpr u32 MAX_MAPPER_BLOB = 8 * 1024 * 1024;
+
+/* Полное состояние консоли для save state и снимков */
+struct SaveState {
+    CPU::State cpu{};
+    PPU::State ppu{};
+    APU::State apu{};
+    Memory::State mem{};
+    Mapper::State mapper{};
+
+    u8 region{0};      /* 0 - NTSC, 1 - PAL, 2 - Dendy */
+    u64 frameCount{0};
+    u64 cpuCycle{0};   /* такт CPU планировщика на момент снимка */
+};
+
+/* Формат с каталогом секций:
+ *   u32 NES_STATE, u32 версия, u32 число секций,
+ *   каталог {u32 тег, u32 смещение, u32 размер} на каждую секцию,
+ *   данные секций.
+ * State-структуры лежат в секциях как есть (порядок байт хоста) и
+ * копируются одним memcpy; секция struct-а другого размера считается
+ * несовместимой. Неизвестные секции при чтении пропускаются.
+ */
+void encodeState(const SaveState &state, std::vector<u8> &out);
+auto decodeState(const u8 *data, sz size, SaveState &state) -> bool;
+
+} /* namespace Core */
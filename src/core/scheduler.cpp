@@ -0,0 +1,97 @@
+#include <algorithm>
+
+#include "core/scheduler.h"
+
+#include "core/apu.h"
+#include "core/cpu.h"
+#include "core/mapper.h"
+
+void Core::Scheduler::attach(CPU *c, PPU *p, APU *a, Mapper *m) {
+    cpu = c;
+    ppu = p;
+    apu = a;
+    mapper = m;
+    resetClock();
+}
+
+void Core::Scheduler::setRegion(PPU::Region region) {
+    /* Смена соотношения тактов: сначала догоняем по старому */
+    sync();
+
+    /* PAL: 3.2 такта PPU на такт CPU, остальные регионы: 3 */
+    ppuNum = (region == PPU::Region::PAL) ? 16u : 3u;
+    ppuDen = (region == PPU::Region::PAL) ? 5u : 1u;
+
+    resetClock();
+}
+
+void Core::Scheduler::resetClock() {
+    cpuCycle = 0;
+    busCycle = 0;
+    ppuDots = 0;
+    apuCycle = 0;
+    nextEvent = 0;
+    irqLine = false;
+}
+
+void Core::Scheduler::restoreClock(u64 cycle) {
+    resetClock();
+
+    cpuCycle = cycle;
+    busCycle = cycle;
+    ppuDots = cycle * ppuNum / ppuDen;
+    apuCycle = cycle;
+}
+
+void Core::Scheduler::syncBus() {
+    catchUp(busCycle);
+
+    /* Запись в регистр могла сдвинуть события: пересчёт в конце инструкции */
+    nextEvent = 0;
+}
+
+void Core::Scheduler::sync() {
+    if (!cpu || !ppu || !apu || !mapper)
+        return;
+
+    catchUp(cpuCycle);
+
+    const auto &apuState = apu->getState();
+    irqLine = mapper->irqFlag || apuState.frameIrq || apuState.dmc.irqFlag;
+
+    predictNextEvent();
+}
+
+void Core::Scheduler::catchUp(u64 cycle) {
+    if (!cpu || !ppu || !apu)
+        return;
+
+    const u64 targetDots = cycle * ppuNum / ppuDen;
+    if (targetDots > ppuDots) {
+        ppu->r.run(targetDots - ppuDots);
+        ppuDots = targetDots;
+    }
+
+    if (ppu->r.nmiPending()) {
+        cpu->c.do_nmi = true;
+        ppu->r.clearNmi();
+    }
+
+    if (cycle > apuCycle) {
+        apu->step(static_cast<u32>(cycle - apuCycle));
+        apuCycle = cycle;
+    }
+}
+
+void Core::Scheduler::predictNextEvent() {
+    const u64 dots = ppu->r.dotsUntilEvent(
+        mapper->needsStep() ? mapper->stepsUntilIRQ() : 0);
+
+    /* Первый такт CPU, к концу которого PPU пройдёт нужный dot */
+    const u64 ppuEvent = ((ppuDots + dots) * ppuDen + ppuNum - 1) / ppuNum;
+    const u64 apuEvent = apuCycle + apu->cyclesUntilEvent();
+
+    nextEvent = std::max(std::min(ppuEvent, apuEvent), cpuCycle + 1);
+}
+
+void Core::Scheduler::raiseIrq() { cpu->c.do_irq = true; }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "common/types.h"
+
+#include "core/ppu.h"
+
+namespace Core {
+class CPU;
+class APU;
+class Mapper;
+
+/* Планировщик догоняющей эмуляции.
+ * CPU идёт впереди и отмечает каждое обращение к шине, а PPU/APU
+ * догоняются до отметки времени CPU только при обращении к их регистрам
+ * или когда наступает ближайшее предсказанное событие (VBlank/NMI,
+ * IRQ маппера, IRQ frame counter/DMC).
+ */
+class Scheduler {
+public:
+    explicit Scheduler() = default;
+    ~Scheduler() = default;
+
+    void attach(CPU *c, PPU *p, APU *a, Mapper *m);
+    void detach() { attach(nullptr, nullptr, nullptr, nullptr); }
+    void setRegion(PPU::Region region);
+
+    /* Сброс часов: все компоненты считаются синхронными */
+    void resetClock();
+
+    /* Часы после загрузки снимка, сделанного сразу после sync():
+     * сохраняет дробную фазу PPU относительно CPU (PAL) */
+    void restoreClock(u64 cycle);
+
+    /* Обращение CPU к шине занимает один такт */
+    inline void busAccess() { ++busCycle; }
+
+    inline void beginInstruction() { busCycle = cpuCycle; }
+    inline void endInstruction(u32 cycles) {
+        cpuCycle += cycles;
+        if (cpuCycle >= nextEvent)
+            sync();
+        if (irqLine)
+            raiseIrq();
+    }
+
+    /* Догнать PPU/APU до текущего обращения CPU (регистры $2000-$4017) */
+    void syncBus();
+
+    /* Догнать PPU/APU до конца последней инструкции */
+    void sync();
+
+    u64 getCpuCycle() const { return cpuCycle; }
+    u64 getPpuDots() const { return ppuDots; }
+    u64 getApuCycle() const { return apuCycle; }
+
+private:
+    void catchUp(u64 cycle);
+    void predictNextEvent();
+    void raiseIrq();
+
+    CPU *cpu{nullptr};
+    PPU *ppu{nullptr};
+    APU *apu{nullptr};
+    Mapper *mapper{nullptr};
+
+    /* PPU dot на такт CPU: ppuNum / ppuDen */
+    u32 ppuNum{3};
+    u32 ppuDen{1};
+
+    u64 cpuCycle{0};  /* конец последней инструкции */
+    u64 busCycle{0};  /* такт текущего обращения CPU к шине */
+    u64 ppuDots{0};   /* сколько dot уже выполнил PPU */
+    u64 apuCycle{0};  /* до какого такта CPU догнан APU */
+    u64 nextEvent{0}; /* такт CPU ближайшего события */
+    bool irqLine{false};
+};
+
+} /* namespace Core */
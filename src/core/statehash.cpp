@@ -0,0 +1,76 @@
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "common/hash.h"
+
+#include "core/statehash.h"
+
+namespace {
+constexpr const char *PART_NAMES[Core::StateHash::COUNT] = {
+    "cpu", "ram", "ppu", "vram", "oam", "palette", "mapper",
+};
+} /* namespace */
+
+u64 Core::StateHash::combined() const {
+    return Common::Hash::xxh64(parts.data(), sizeof(parts));
+}
+
+auto Core::StateHash::partName(sz part) -> const char * {
+    return (part < COUNT) ? PART_NAMES[part] : "?";
+}
+
+Core::HashLog::HashLog(const std::filesystem::path &path)
+    : file(path, std::ios::trunc) {
+    if (!file)
+        throw std::runtime_error("[HASH]: Не удалось открыть " +
+                                 path.string());
+}
+
+void Core::HashLog::write(u64 frame, const StateHash &hash) {
+    file << format(frame, hash) << '\n';
+}
+
+auto Core::HashLog::format(u64 frame, const StateHash &hash) -> std::string {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%" PRIu64, static_cast<uint64_t>(frame));
+    std::string line = buf;
+
+    std::snprintf(buf, sizeof(buf), " %016" PRIx64,
+                  static_cast<uint64_t>(hash.combined()));
+    line += buf;
+
+    for (const u64 part : hash.parts) {
+        std::snprintf(buf, sizeof(buf), " %016" PRIx64,
+                      static_cast<uint64_t>(part));
+        line += buf;
+    }
+    return line;
+}
+
+bool Core::HashLog::parse(const std::string &line, u64 &frame,
+                          StateHash &hash) {
+    const char *p = line.c_str();
+    char *end = nullptr;
+
+    frame = std::strtoull(p, &end, 10);
+    if (end == p)
+        return false;
+    p = end;
+
+    const u64 combined = std::strtoull(p, &end, 16);
+    if (end == p)
+        return false;
+    p = end;
+
+    for (u64 &part : hash.parts) {
+        part = std::strtoull(p, &end, 16);
+        if (end == p)
+            return false;
+        p = end;
+    }
+
+    /* Общий хэш - проверка, что строка не обрезана */
+    return combined == hash.combined();
+}
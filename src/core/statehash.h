@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "common/types.h"
+
+namespace Core {
+/* Хэши частей состояния консоли (Console::stateHash()): два прогона
+ * разошлись, если на одном кадре разошёлся хоть один хэш, а часть
+ * показывает, где искать */
+struct StateHash {
+    enum Part : u8 {
+        CPU = 0, /* регистры и такт CPU */
+        RAM,     /* 2 КБ RAM консоли */
+        PPU,     /* регистры, scanline/dot */
+        VRAM,    /* nametable RAM */
+        OAM,
+        PALETTE,
+        MAPPER, /* банки, mirroring, IRQ, PRG-RAM, CHR-RAM */
+        COUNT
+    };
+
+    std::array<u64, COUNT> parts{};
+
+    u64 combined() const;
+    static auto partName(sz part) -> const char *;
+
+    bool operator==(const StateHash &o) const { return parts == o.parts; }
+    bool operator!=(const StateHash &o) const { return parts != o.parts; }
+};
+
+/* Поток хэшей в текстовом файле, строка на кадр:
+ * "кадр общий cpu ram ppu vram oam palette mapper" (числа кроме кадра -
+ * 16 hex-цифр). Текст удобно сравнивать и обычным diff */
+class HashLog {
+public:
+    explicit HashLog(const std::filesystem::path &path);
+    ~HashLog() = default;
+
+    void write(u64 frame, const StateHash &hash);
+
+    static auto format(u64 frame, const StateHash &hash) -> std::string;
+    static bool parse(const std::string &line, u64 &frame, StateHash &hash);
+
+private:
+    std::ofstream file;
+};
+
+} /* namespace Core */
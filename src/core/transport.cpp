@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "core/transport.h"
+
+namespace {
+#if defined(_WIN32)
+using SocketHandle = SOCKET;
+const std::uintptr_t NO_SOCKET = static_cast<std::uintptr_t>(INVALID_SOCKET);
+#else
+using SocketHandle = int;
+const std::uintptr_t NO_SOCKET = static_cast<std::uintptr_t>(-1);
+#endif
+
+auto handle(std::uintptr_t sock) -> SocketHandle {
+    return static_cast<SocketHandle>(sock);
+}
+
+void closeSocket(std::uintptr_t sock) {
+#if defined(_WIN32)
+    closesocket(handle(sock));
+#else
+    ::close(handle(sock));
+#endif
+}
+
+/* Тот же адрес и порт; остальные поля sockaddr (sin_zero, flowinfo) не
+ * сравниваются */
+auto sameEndpoint(const sockaddr_storage &from, const std::vector<u8> &addr)
+    -> bool {
+    sockaddr_storage expected{};
+    std::memcpy(&expected, addr.data(),
+                std::min(addr.size(), sizeof(expected)));
+    if (from.ss_family != expected.ss_family)
+        return false;
+
+    if (from.ss_family == AF_INET6) {
+        const auto *a = reinterpret_cast<const sockaddr_in6 *>(&from);
+        const auto *b = reinterpret_cast<const sockaddr_in6 *>(&expected);
+        return a->sin6_port == b->sin6_port &&
+               std::memcmp(&a->sin6_addr, &b->sin6_addr,
+                           sizeof(a->sin6_addr)) == 0;
+    }
+
+    const auto *a = reinterpret_cast<const sockaddr_in *>(&from);
+    const auto *b = reinterpret_cast<const sockaddr_in *>(&expected);
+    return a->sin_port == b->sin_port &&
+           a->sin_addr.s_addr == b->sin_addr.s_addr;
+}
+
+auto setNonBlocking(std::uintptr_t sock) -> bool {
+#if defined(_WIN32)
+    u_long on = 1;
+    return ioctlsocket(handle(sock), FIONBIO, &on) == 0;
+#else
+    const int flags = fcntl(handle(sock), F_GETFL, 0);
+    return flags >= 0 &&
+           fcntl(handle(sock), F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+} /* namespace */
+
+/* Loopback */
+Core::LoopbackTransport::LoopbackTransport(std::shared_ptr<Channel> in,
+                                           std::shared_ptr<Channel> out,
+                                           u32 latency, u32 lossPercent,
+                                           u32 seed)
+    : in(std::move(in)), out(std::move(out)), latency(latency),
+      lossPercent(lossPercent), seed(seed) {}
+
+auto Core::LoopbackTransport::makePair(u32 latency, u32 lossPercent)
+    -> std::pair<std::unique_ptr<LoopbackTransport>,
+                 std::unique_ptr<LoopbackTransport>> {
+    auto ab = std::make_shared<Channel>();
+    auto ba = std::make_shared<Channel>();
+
+    return {std::unique_ptr<LoopbackTransport>(
+                new LoopbackTransport(ba, ab, latency, lossPercent, 1)),
+            std::unique_ptr<LoopbackTransport>(
+                new LoopbackTransport(ab, ba, latency, lossPercent, 2))};
+}
+
+void Core::LoopbackTransport::send(const u8 *data, sz size) {
+    if (lossPercent > 0) {
+        seed = seed * 1664525u + 1013904223u;
+        if ((seed >> 16) % 100 < lossPercent)
+            return;
+    }
+
+    std::lock_guard<std::mutex> lock(out->mutex);
+    out->packets.push_back({std::vector<u8>(data, data + size),
+                            out->clock + latency});
+}
+
+bool Core::LoopbackTransport::receive(std::vector<u8> &outData) {
+    std::lock_guard<std::mutex> lock(in->mutex);
+    if (!in->packets.empty() && in->packets.front().readyAt <= in->clock) {
+        outData = std::move(in->packets.front().data);
+        in->packets.pop_front();
+        return true;
+    }
+
+    ++in->clock;
+    return false;
+}
+
+/* UDP */
+Core::UdpTransport::UdpTransport(u16 localPort, const std::string &host,
+                                 u16 remotePort)
+    : sock(NO_SOCKET), buffer(MAX_DATAGRAM) {
+#if defined(_WIN32)
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
+        throw std::runtime_error("[NET]: WSAStartup не удался");
+#endif
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo *found = nullptr;
+    const std::string port = std::to_string(remotePort);
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &found) != 0 ||
+        !found) {
+        close();
+        throw std::runtime_error("[NET]: Не удалось найти адрес " + host);
+    }
+
+    const int family = found->ai_family;
+    remoteAddr.assign(reinterpret_cast<const u8 *>(found->ai_addr),
+                      reinterpret_cast<const u8 *>(found->ai_addr) +
+                          found->ai_addrlen);
+    freeaddrinfo(found);
+
+    sock = static_cast<std::uintptr_t>(socket(family, SOCK_DGRAM, 0));
+    if (sock == NO_SOCKET) {
+        close();
+        throw std::runtime_error("[NET]: Не удалось создать сокет");
+    }
+
+    /* Слушаем на любом адресе того же семейства */
+    sockaddr_storage local{};
+    socklen_t localLen = 0;
+    if (family == AF_INET6) {
+        auto *a = reinterpret_cast<sockaddr_in6 *>(&local);
+        a->sin6_family = AF_INET6;
+        a->sin6_addr = in6addr_any;
+        a->sin6_port = htons(localPort);
+        localLen = sizeof(sockaddr_in6);
+    } else {
+        auto *a = reinterpret_cast<sockaddr_in *>(&local);
+        a->sin_family = AF_INET;
+        a->sin_addr.s_addr = htonl(INADDR_ANY);
+        a->sin_port = htons(localPort);
+        localLen = sizeof(sockaddr_in);
+    }
+
+    if (bind(handle(sock), reinterpret_cast<const sockaddr *>(&local),
+             localLen) != 0) {
+        close();
+        throw std::runtime_error("[NET]: Порт " + std::to_string(localPort) +
+                                 " занят");
+    }
+
+    if (!setNonBlocking(sock)) {
+        close();
+        throw std::runtime_error("[NET]: Не удалось перевести сокет в "
+                                 "неблокирующий режим");
+    }
+}
+
+Core::UdpTransport::~UdpTransport() { close(); }
+
+void Core::UdpTransport::close() {
+    if (sock != NO_SOCKET) {
+        closeSocket(sock);
+        sock = NO_SOCKET;
+    }
+
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+void Core::UdpTransport::send(const u8 *data, sz size) {
+    /* Ошибки отправки не фатальны: потерю пакета покроет повтор */
+    sendto(handle(sock), reinterpret_cast<const char *>(data),
+           static_cast<int>(size), 0,
+           reinterpret_cast<const sockaddr *>(remoteAddr.data()),
+           static_cast<socklen_t>(remoteAddr.size()));
+}
+
+bool Core::UdpTransport::receive(std::vector<u8> &out) {
+    /* Датаграммы не от собеседника пропускаются, ищем следующую */
+    for (;;) {
+        sockaddr_storage from{};
+        socklen_t fromLen = sizeof(from);
+        const auto got = recvfrom(
+            handle(sock), reinterpret_cast<char *>(buffer.data()),
+            static_cast<int>(buffer.size()), 0,
+            reinterpret_cast<sockaddr *>(&from), &fromLen);
+        if (got <= 0)
+            return false;
+
+        if (!sameEndpoint(from, remoteAddr))
+            continue;
+
+        out.assign(buffer.begin(), buffer.begin() + got);
+        return true;
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/types.h"
+
+namespace Core {
+/* Канал датаграмм для netplay: пакеты могут теряться и переставляться,
+ * но не дробятся. Оба метода не блокируют.
+ */
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    virtual void send(const u8 *data, sz size) = 0;
+
+    /* Следующий пришедший пакет; false - пока ничего нет */
+    virtual bool receive(std::vector<u8> &out) = 0;
+};
+
+/* Оба конца в одном процессе (тесты, бенчмарки, две консоли в одном окне).
+ * latency - на сколько опросов "до пустой очереди" получателя задержать
+ * пакет (сессия опрашивает раз в кадр, так что это задержка в кадрах),
+ * lossPercent - доля теряемых пакетов (детерминированно).
+ */
+class LoopbackTransport : public Transport {
+public:
+    static auto makePair(u32 latency = 0, u32 lossPercent = 0)
+        -> std::pair<std::unique_ptr<LoopbackTransport>,
+                     std::unique_ptr<LoopbackTransport>>;
+
+    void send(const u8 *data, sz size) override;
+    bool receive(std::vector<u8> &out) override;
+
+private:
+    struct Packet {
+        std::vector<u8> data;
+        u64 readyAt{0};
+    };
+
+    /* Очередь к одному концу; clock - его опросы */
+    struct Channel {
+        std::mutex mutex;
+        std::deque<Packet> packets;
+        u64 clock{0};
+    };
+
+    LoopbackTransport(std::shared_ptr<Channel> in,
+                      std::shared_ptr<Channel> out, u32 latency,
+                      u32 lossPercent, u32 seed);
+
+    std::shared_ptr<Channel> in;
+    std::shared_ptr<Channel> out;
+    u32 latency;
+    u32 lossPercent;
+    u32 seed;
+};
+
+/* UDP к одному собеседнику: слушает localPort, шлёт на host:remotePort.
+ * Датаграммы с других адресов и портов отбрасываются.
+ */
+class UdpTransport : public Transport {
+public:
+    explicit UdpTransport(u16 localPort, const std::string &host,
+                          u16 remotePort);
+    ~UdpTransport() override;
+
+    UdpTransport(const UdpTransport &) = delete;
+    auto operator=(const UdpTransport &) -> UdpTransport & = delete;
+
+    void send(const u8 *data, sz size) override;
+    bool receive(std::vector<u8> &out) override;
+
+private:
+    static inline constexpr sz MAX_DATAGRAM = 1500;
+
+    void close();
+
+    std::uintptr_t sock;
+    std::vector<u8> remoteAddr; /* sockaddr собеседника */
+    std::vector<u8> buffer;
+};
+
+} /* namespace Core */
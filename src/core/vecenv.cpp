@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "core/vecenv.h"
+
+Core::VecEnv::VecEnv(const std::filesystem::path &romPath,
+                     const std::filesystem::path &mapperDir,
+                     const Config &cfg)
+    : config(cfg) {
+    if (config.count == 0)
+        throw std::runtime_error("[VECENV]: Нужна хотя бы одна консоль");
+
+    if (config.observation == Observation::GRAY) {
+        const u32 d = config.downscale;
+        if (d != 1 && d != 2 && d != 4 && d != 8)
+            throw std::runtime_error(
+                "[VECENV]: downscale должен быть 1, 2, 4 или 8");
+        width = PPU::WIDTH / d;
+        height = PPU::HEIGHT / d;
+    }
+
+    for (sz i = 0; i < luma.size(); ++i) {
+        const u32 rgb = PPU::PALETTE[i];
+        const f64 y = 0.299 * ((rgb >> 16) & 0xFF) +
+                      0.587 * ((rgb >> 8) & 0xFF) + 0.114 * (rgb & 0xFF);
+        luma[i] = static_cast<u8>(std::min(y + 0.5, 255.0));
+    }
+
+    /* Файл ROM читается один раз: остальные консоли получают образ
+     * картриджа первой и её снимок после включения */
+    consoles.reserve(config.count);
+    for (sz i = 0; i < config.count; ++i) {
+        auto console = std::make_unique<Console>();
+        console->luaMappers = config.luaMappers;
+        console->setRegion(config.region);
+        if (i == 0) {
+            console->loadRom(romPath, mapperDir);
+            console->saveSnapshot(initialSnapshot);
+        } else {
+            console->loadRom(*consoles.front(), mapperDir);
+            console->loadSnapshot(initialSnapshot);
+        }
+        console->ppu->indexedOutput = true;
+        consoles.push_back(std::move(console));
+    }
+
+    obs.resize(config.count * obsSize());
+    rams.resize(config.count * RAM_SIZE);
+    stalls.resize(config.count);
+    inputs1.resize(config.count);
+    inputs2.resize(config.count);
+
+    for (sz i = 0; i < config.count; ++i)
+        observe(i);
+
+    sz threads = config.threads;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, config.count);
+
+    pool = std::make_unique<Common::Thread::WorkPool>(
+        static_cast<u32>(threads));
+}
+
+Core::VecEnv::~VecEnv() = default;
+
+void Core::VecEnv::step(const u8 *joy1, const u8 *joy2) {
+    if (joy1)
+        std::copy(joy1, joy1 + size(), inputs1.begin());
+    else
+        std::fill(inputs1.begin(), inputs1.end(), 0);
+
+    if (joy2)
+        std::copy(joy2, joy2 + size(), inputs2.begin());
+    else
+        std::fill(inputs2.begin(), inputs2.end(), 0);
+
+    for (sz i = 0; i < size(); ++i)
+        pool->submit([this, i]() { stepOne(i); }, static_cast<u32>(i));
+    pool->wait();
+
+    stats = pool->takeStats();
+}
+
+void Core::VecEnv::reset() {
+    for (sz i = 0; i < size(); ++i)
+        reset(i);
+}
+
+void Core::VecEnv::reset(sz index) {
+    Console &c = *consoles[index];
+    c.loadSnapshot(initialSnapshot);
+
+    /* Кадр в снимок не входит: как сразу после загрузки ROM */
+    c.ppu->indexFrame.fill(0);
+
+    stalls[index] = 0;
+    observe(index);
+}
+
+void Core::VecEnv::stepOne(sz index) {
+    Console &c = *consoles[index];
+    c.setJoy1(inputs1[index]);
+    c.setJoy2(inputs2[index]);
+
+    stalls[index] = c.runFrame() ? 0 : 1;
+    c.apu->samples.clear();
+
+    observe(index);
+}
+
+void Core::VecEnv::observe(sz index) {
+    const Console &c = *consoles[index];
+    const auto &frame = c.ppu->indexFrame;
+    u8 *out = &obs[index * obsSize()];
+
+    std::copy_n(c.mem->getState().ram.data(), RAM_SIZE,
+                &rams[index * RAM_SIZE]);
+
+    if (config.observation == Observation::INDEX) {
+        for (sz i = 0; i < frame.size(); ++i)
+            out[i] = static_cast<u8>(frame[i] & 0x3F);
+        return;
+    }
+
+    /* Среднее яркости по блоку d x d */
+    const sz d = config.downscale;
+    const u32 area = static_cast<u32>(d * d);
+    for (sz y = 0; y < height; ++y) {
+        for (sz x = 0; x < width; ++x) {
+            u32 sum = 0;
+            for (sz dy = 0; dy < d; ++dy) {
+                const u16 *row = &frame[(y * d + dy) * PPU::WIDTH + x * d];
+                for (sz dx = 0; dx < d; ++dx)
+                    sum += luma[row[dx] & 0x3F];
+            }
+            out[y * width + x] = static_cast<u8>(sum / area);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "common/pool.h"
+#include "common/types.h"
+
+#include "core/console.h"
+
+namespace Core {
+/* Пачка независимых консолей с одним ROM, которые шагают кадр за кадром
+ * синхронно (для обучения агентов).
+ * step() раздаёт консоли пулу потоков (консоль i закреплена за одним
+ * рабочим, чтобы её состояние не переезжало между кэшами), каждая
+ * проходит один кадр со своим вводом и пишет наблюдение в общий заранее
+ * выделенный буфер: наблюдение i лежит по смещению i * obsSize(), RAM -
+ * по i * RAM_SIZE.
+ * reset(i) загружает снимок, сделанный сразу после загрузки ROM, вместо
+ * повторного разбора ROM и Lua.
+ */
+class VecEnv {
+public:
+    static inline constexpr sz RAM_SIZE = 2048;
+
+    enum class Observation : u8 {
+        INDEX = 0, /* индексы палитры 0-63, 256x240 */
+        GRAY = 1,  /* яркость 0-255, уменьшенная в downscale раз */
+    };
+
+    struct Config {
+        sz count{1};
+        Observation observation{Observation::INDEX};
+        u32 downscale{2};  /* только для GRAY: 1, 2, 4 или 8 */
+        u32 threads{0};    /* 0 - по числу ядер */
+        PPU::Region region{PPU::Region::NTSC};
+        bool luaMappers{false};
+    };
+
+public:
+    explicit VecEnv(const std::filesystem::path &romPath,
+                    const std::filesystem::path &mapperDir,
+                    const Config &config);
+    ~VecEnv();
+
+    VecEnv(const VecEnv &) = delete;
+    auto operator=(const VecEnv &) -> VecEnv & = delete;
+
+    /* Один кадр всех консолей; joy1/joy2 - по байту на консоль
+     * (nullptr - кнопки не нажаты) */
+    void step(const u8 *joy1, const u8 *joy2 = nullptr);
+
+    void reset();
+    void reset(sz index);
+
+    sz size() const { return consoles.size(); }
+    sz obsWidth() const { return width; }
+    sz obsHeight() const { return height; }
+    sz obsSize() const { return width * height; }
+
+    const u8 *observations() const { return obs.data(); }
+    const u8 *ram() const { return rams.data(); }
+
+    /* Консоль не дошла до VBlank за кадр (CPU застрял) */
+    bool stalled(sz index) const { return stalls[index] != 0; }
+
+    Console &console(sz index) { return *consoles[index]; }
+
+    /* Ожидание и время работы каждой консоли на последнем step() */
+    const std::vector<Common::Thread::WorkPool::TaskStats> &stepStats() const {
+        return stats;
+    }
+
+private:
+    void stepOne(sz index);
+    void observe(sz index);
+
+    Config config;
+    sz width{PPU::WIDTH};
+    sz height{PPU::HEIGHT};
+
+    std::vector<std::unique_ptr<Console>> consoles;
+    std::vector<u8> initialSnapshot;
+
+    std::vector<u8> obs;
+    std::vector<u8> rams;
+    std::vector<u8> stalls;
+    std::vector<u8> inputs1;
+    std::vector<u8> inputs2;
+
+    /* Яркость цветов PPU::PALETTE */
+    std::array<u8, 64> luma{};
+
+    std::unique_ptr<Common::Thread::WorkPool> pool;
+    std::vector<Common::Thread::WorkPool::TaskStats> stats;
+};
+
+} /* namespace Core */
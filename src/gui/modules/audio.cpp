@@ -37,10 +37,14 @@ void NesAudio::reset() {
 }
 
 void NesAudio::pushSamples(const std::vector<f32> &samples) {
+    pushSamples(samples.data(), samples.size());
+}
+
+void NesAudio::pushSamples(const f32 *samples, sz count) {
     if (!enabled || !sink || !io)
         return;
 
-    appendSamples(samples);
+    appendSamples(samples, count);
     drainSink();
 }
 
@@ -77,11 +81,11 @@ void NesAudio::clearRing() {
     ringUsed = 0;
 }
 
-void NesAudio::appendSamples(const std::vector<f32> &samples) {
-    if (samples.empty())
+void NesAudio::appendSamples(const f32 *samples, sz count) {
+    if (count == 0)
         return;
 
-    const qsizetype totalFrames = static_cast<qsizetype>(samples.size());
+    const qsizetype totalFrames = static_cast<qsizetype>(count);
     const qsizetype frameCount = std::min(totalFrames, MAX_FRAMES);
     const qsizetype startFrame = totalFrames - frameCount;
 
@@ -25,6 +25,7 @@ public:
 
     void reset();
     void pushSamples(const std::vector<f32> &samples);
+    void pushSamples(const f32 *samples, sz count);
 
     void setEnabled(bool enabled);
     bool isEnabled() const { return enabled; }
@@ -35,7 +36,7 @@ public:
 private:
     static qint16 toI16(f32 sample);
     void clearRing();
-    void appendSamples(const std::vector<f32> &samples);
+    void appendSamples(const f32 *samples, sz count);
     void drainSink();
 
 private:
@@ -9,8 +9,8 @@ WFrame::WFrame(QWidget *parent) : QFrame(parent) {
 }
 
 void WFrame::setFrameBuffer(
-    const std::array<u32, WIDTH * HEIGHT> &newFrameData) {
-    frameData = newFrameData;
+    const std::array<u16, WIDTH * HEIGHT> &indexData) {
+    palette.convert(indexData, frameData);
 
     if (frameView.isNull()) {
         frameView = QImage(
@@ -3,6 +3,7 @@
 #include <QFrame>
 #include <QPainter>
 
+#include "core/palette.h"
 #include "core/ppu.h"
 
 class WFrame : public QFrame {
@@ -14,7 +15,9 @@ public:
     explicit WFrame(QWidget *p = nullptr);
     ~WFrame() = default;
 
-    void setFrameBuffer(const std::array<u32, WIDTH * HEIGHT> &newFrameData);
+    /* Индексный кадр PPU; в RGB переводится здесь, один раз на показ */
+    void setFrameBuffer(const std::array<u16, WIDTH * HEIGHT> &indexData);
+    void setPalette(const Core::Palette &newPalette) { palette = newPalette; }
     void clear();
 
 protected:
@@ -22,6 +25,7 @@ protected:
 
 private:
     std::array<u32, WIDTH * HEIGHT> frameData{};
+    Core::Palette palette;
     bool hasFrame{false};
     QImage frameView;
 };
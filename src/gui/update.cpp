@@ -18,10 +18,17 @@
 #endif
 
 namespace {
-struct EmuFrameData {
-    std::array<u32, Core::PPU::WIDTH * Core::PPU::HEIGHT> frame{};
-    std::vector<f32> audio;
-};
+using EmuFrame = std::array<u16, Core::PPU::WIDTH * Core::PPU::HEIGHT>;
+
+/* ~0.7 с стерео при 44.1 кГц */
+constexpr sz EMU_AUDIO_CAPACITY = 1u << 16;
+
+auto frameDuration(bool palLike) -> std::chrono::steady_clock::duration {
+    if (palLike)
+        return std::chrono::milliseconds(20);
+
+    return std::chrono::microseconds(16667);
+}
 
 auto noAudio() -> const std::vector<f32> & {
     static const std::vector<f32> v;
@@ -188,7 +195,11 @@ struct WUpdate::DebugWorker {
 
 struct WUpdate::EmuWorker {
     std::mutex coreMutex;
-    Common::Thread::LatestValue<EmuFrameData> output;
+
+    /* Поток эмуляции -> GUI: без блокировок и аллокаций на кадр */
+    Common::Thread::TripleBuffer<EmuFrame> frames;
+    Common::Thread::SpscRing<f32, EMU_AUDIO_CAPACITY> audio;
+    std::vector<f32> audioOut = std::vector<f32>(audio.capacity());
     std::unique_ptr<Common::Thread::PausableLoopWorker> loop;
     std::chrono::steady_clock::time_point nextTick{};
     bool nextTickInit{false};
@@ -224,26 +235,45 @@ void WUpdate::emuWorkerTick() {
 
     using clock = std::chrono::steady_clock;
 
-    std::unique_ptr<EmuFrameData> out;
+    const auto tickStart = clock::now();
     bool canRun = false;
     bool palLike = false;
+    bool uncapped = false;
 
     {
         std::lock_guard<std::mutex> coreLock(emuWorker->coreMutex);
 
-        canRun = main && main->romLoaded && !main->paused && main->ppu &&
-                 main->apu && main->mem && main->mapper && main->cpu;
+        canRun = main && main->romLoaded && !main->paused &&
+                 main->console.isLoaded();
         palLike = main && ((main->emuRegion == Core::PPU::Region::PAL) ||
                            (main->emuRegion == Core::PPU::Region::DENDY));
 
         if (canRun) {
-            out = std::make_unique<EmuFrameData>();
-
-            emulateFrameCore();
-
-            out->frame = main->ppu->frame;
-            out->audio = std::move(main->apu->samples);
-            main->apu->samples.clear();
+            /* Перемотка: лишние кадры без звука и картинки, показывается
+             * только последний. Без ограничения - сколько успеет за время
+             * обычного кадра. Собеседник netplay не перематывается */
+            const bool turbo = main->fastForward && !main->netplay;
+            const u32 speed = turbo ? main->fastForwardSpeed : 1;
+            uncapped = turbo && speed == 0;
+
+            if (uncapped) {
+                const auto deadline = tickStart + frameDuration(palLike);
+                while (!main->paused && clock::now() < deadline)
+                    emulateFrameCore(false);
+            }
+            for (u32 i = 1; i < speed && !main->paused; ++i)
+                emulateFrameCore(false);
+
+            if (!main->paused)
+                emulateFrameCore();
+
+            /* Если GUI не успевает забирать звук, лишний кадр звука
+             * отбрасывается целиком */
+            auto &samples = main->console.apu->samples;
+            emuWorker->audio.tryPush(samples.data(), samples.size());
+            samples.clear();
+
+            emuWorker->frames.back() = main->console.ppu->indexFrame;
         }
     }
 
@@ -253,17 +283,19 @@ void WUpdate::emuWorkerTick() {
         return;
     }
 
+    emuWorker->frames.publish();
+
+    if (uncapped) {
+        emuWorker->nextTickInit = false;
+        return;
+    }
+
     if (!emuWorker->nextTickInit) {
         emuWorker->nextTick = clock::now();
         emuWorker->nextTickInit = true;
     }
 
-    const auto frameDuration = palLike ? std::chrono::milliseconds(20)
-                                       : std::chrono::microseconds(16667);
-    emuWorker->nextTick += frameDuration;
-
-    if (out)
-        emuWorker->output.publish(std::move(*out));
+    emuWorker->nextTick += frameDuration(palLike);
 
     const auto now = clock::now();
     if (now < emuWorker->nextTick)
@@ -334,15 +366,19 @@ auto WUpdate::applyReadyEmuFrame() -> bool {
     if (!main || !emuWorker)
         return false;
 
-    auto ready = emuWorker->output.tryTake();
-    if (!ready.has_value())
+    const EmuFrame *frame = emuWorker->frames.tryTake();
+    if (!frame)
         return false;
 
+    /* audioOut размером с кольцо: pop() забирает всё накопленное */
+    auto &audioOut = emuWorker->audioOut;
+    const sz samples = emuWorker->audio.pop(audioOut.data(), audioOut.size());
+
     if (main->audio)
-        main->audio->pushSamples(ready->audio);
+        main->audio->pushSamples(audioOut.data(), samples);
 
     if (main->ui && main->ui->frameView)
-        main->ui->frameView->setFrameBuffer(ready->frame);
+        main->ui->frameView->setFrameBuffer(*frame);
 
     return true;
 }
@@ -407,7 +443,8 @@ void WUpdate::stopDebugWorker() {
 }
 
 void WUpdate::submitDebugSnapshot() {
-    if (!main || !main->cpu || !main->ppu || !main->logsWindow || !debugWorker)
+    if (!main || !main->console.isLoaded() || !main->logsWindow ||
+        !debugWorker)
         return;
 
     std::unique_lock<std::mutex> coreLock;
@@ -416,10 +453,10 @@ void WUpdate::submitDebugSnapshot() {
 
     DebugSnapshot snapshot{};
 
-    const auto &regs = main->cpu->c.regs;
-    snapshot.opName = QString::fromStdString(main->cpu->getLastOpName());
+    const auto &regs = main->console.cpu->c.regs;
+    snapshot.opName = QString::fromStdString(main->console.cpu->getLastOpName());
     snapshot.amName =
-        QString::fromLatin1(toAddrModeString(main->cpu->getLastAddrMode()));
+        QString::fromLatin1(toAddrModeString(main->console.cpu->getLastAddrMode()));
 
     snapshot.a = regs.A;
     snapshot.x = regs.X;
@@ -427,13 +464,13 @@ void WUpdate::submitDebugSnapshot() {
     snapshot.p = regs.P;
     snapshot.sp = regs.SP;
     snapshot.pc = regs.PC;
-    snapshot.cycles = main->cpu->c.op_cycles;
+    snapshot.cycles = main->console.cpu->c.op_cycles;
 
-    snapshot.nmiPending = main->cpu->c.do_nmi;
-    snapshot.irqPending = main->cpu->c.do_irq;
+    snapshot.nmiPending = main->console.cpu->c.do_nmi;
+    snapshot.irqPending = main->console.cpu->c.do_irq;
     snapshot.irqMasked = (regs.P & Core::CPU::C6502::I) != 0;
 
-    const auto &state = main->ppu->getState();
+    const auto &state = main->console.ppu->getState();
     snapshot.ppuctrl = state.ppuctrl;
     snapshot.ppumask = state.ppumask;
     snapshot.ppustatus = state.ppustatus;
@@ -462,8 +499,8 @@ void WUpdate::submitDebugSnapshot() {
 
     if (updatePatternTables) {
         snapshot.withPatterns = true;
-        snapshot.pt0 = main->ppu->r.getPttrnTable(0);
-        snapshot.pt1 = main->ppu->r.getPttrnTable(1);
+        snapshot.pt0 = main->console.ppu->r.getPttrnTable(0);
+        snapshot.pt1 = main->console.ppu->r.getPttrnTable(1);
     }
 
     debugWorker->worker.submit(std::move(snapshot));
@@ -551,31 +588,54 @@ void WUpdate::doFrame() {
     presentAudioAndVideo();
 }
 
-void WUpdate::emulateFrameCore() {
-    if (!main || !main->mapper || !main->ppu || !main->apu || !main->mem ||
-        !main->cpu)
+void WUpdate::emulateFrameCore(bool present) {
+    if (!main || !main->console.isLoaded())
         return;
 
-    syncInputToMemory();
+    /* Ввод обоих джойпадов раздаёт сессия */
+    if (main->netplay) {
+        if (!main->netplay->advance(main->joyState))
+            main->paused = true;
+        return;
+    }
 
-    static constexpr u32 kMaxCpuInstructionsPerFrame = 2000000;
-    u32 safetyCounter = 0;
+    auto *movie = main->movie.get();
 
-    main->ppu->r.frameReady = false;
-    while (!main->ppu->r.frameReady) {
-        runCpuInstruction();
+    /* Перемотка назад: снимок из кольца и кадр после него без звука.
+     * Пустое кольцо - игра стоит на самом старом снимке. С записью ввода
+     * кольцо не работает: перемотка разошлась бы с файлом */
+    if (main->rewinding && !movie) {
+        if (main->rewind.rewind(main->console) &&
+            !main->console.runFrameMuted(present))
+            main->paused = true;
+        return;
+    }
 
-        if (++safetyCounter >= kMaxCpuInstructionsPerFrame) {
-            if (main)
-                main->paused = true;
-            break;
-        }
+    /* Запись берёт ввод с клавиатуры, проигрывание - из файла */
+    u8 joy1 = 0;
+    u8 joy2 = 0;
+    if (movie && !main->movieRecording && movie->next(joy1, joy2)) {
+        main->console.setJoy1(joy1);
+        main->console.setJoy2(joy2);
+    } else {
+        if (movie && main->movieRecording)
+            movie->record(main->joyState, main->joyStateP2);
+        syncInputToMemory();
     }
+
+    /* Пропущенному кадру run-ahead не нужен: состояние то же */
+    const bool ok =
+        present ? main->console.runFrameAhead(main->runAheadFrames.load())
+                : main->console.runFrameMuted(false);
+    if (!ok)
+        main->paused = true;
+    else if (!movie)
+        main->rewind.push(main->console);
 }
 
 #if defined(DEBUG)
 void WUpdate::updDebugPanels() {
-    if (!main || !main->cpu || !main->ppu || !main->logsWindow)
+    if (!main || !main->console.isLoaded() || !main->logsWindow)
         return;
 
     applyReadyDebugResult();
@@ -614,6 +674,20 @@ void WUpdate::updWindowTitle() {
     if (main->paused)
         title += QStringLiteral(" [PAUSED]");
 
+    if (main->netplay)
+        title += main->netplay->desynced() ? QStringLiteral(" [DESYNC]")
+                                           : QStringLiteral(" [NETPLAY]");
+
+    if (main->movie && main->movieRecording)
+        title += QStringLiteral(" [REC]");
+    else if (main->movie && !main->movie->finished())
+        title += QStringLiteral(" [MOVIE]");
+
+    if (main->rewinding && !main->netplay && !main->movie)
+        title += QStringLiteral(" [REWIND]");
+    else if (main->fastForward && !main->netplay)
+        title += QStringLiteral(" [FAST]");
+
     title += QStringLiteral(" - FPS: %1").arg(main->currFps, 0, 'f', 1);
 
     main->setWindowTitle(title);
@@ -624,85 +698,62 @@ void WUpdate::syncDebugFlagsFromLogWindow() {
         return;
 
 #if !defined(DEBUG)
-    if (main->cpu)
-        main->cpu->debug = false;
-    if (main->ppu)
-        main->ppu->debug = false;
-    if (main->apu)
-        main->apu->debug = false;
-    if (main->mem)
-        main->mem->debug = false;
-    if (main->mapper)
-        main->mapper->debug = false;
+    if (main->console.cpu)
+        main->console.cpu->debug = false;
+    if (main->console.ppu)
+        main->console.ppu->debug = false;
+    if (main->console.apu)
+        main->console.apu->debug = false;
+    if (main->console.mem)
+        main->console.mem->debug = false;
+    if (main->console.mapper)
+        main->console.mapper->debug = false;
 #else
     const bool hasLogs =
         static_cast<bool>(main->logsWindow) && main->logsWindow->isVisible();
 
-    if (main->cpu)
-        main->cpu->debug = hasLogs && main->logsWindow->allowCpu();
-    if (main->ppu)
-        main->ppu->debug = hasLogs && main->logsWindow->allowPpu();
-    if (main->apu)
-        main->apu->debug = false;
-    if (main->mem)
-        main->mem->debug = false;
-    if (main->mapper)
-        main->mapper->debug = false;
+    if (main->console.cpu)
+        main->console.cpu->debug = hasLogs && main->logsWindow->allowCpu();
+    if (main->console.ppu)
+        main->console.ppu->debug = hasLogs && main->logsWindow->allowPpu();
+    if (main->console.apu)
+        main->console.apu->debug = false;
+    if (main->console.mem)
+        main->console.mem->debug = false;
+    if (main->console.mapper)
+        main->console.mapper->debug = false;
 #endif
 }
 
 void WUpdate::syncInputToMemory() {
-    if (!main || !main->mem)
+    if (!main)
         return;
 
-    main->mem->setJoy1(main->joyState);
-    main->mem->setJoy2(main->joyStateP2);
+    main->console.setJoy1(main->joyState);
+    main->console.setJoy2(main->joyStateP2);
 }
 
 void WUpdate::runCpuInstruction() {
-    if (!main || !main->mapper || !main->ppu || !main->apu || !main->mem ||
-        !main->cpu)
+    if (!main)
         return;
 
-    main->cpu->exec();
-
-    u32 cycles = main->cpu->c.op_cycles;
-    if (cycles == 0)
-        cycles = 1;
-
-    const u32 ppuNum = (main->emuRegion == Core::PPU::Region::PAL) ? 16u : 3u;
-    const u32 ppuDen = (main->emuRegion == Core::PPU::Region::PAL) ? 5u : 1u;
-    const u32 totalPhase = main->ppuPhaseAcc + (cycles * ppuNum);
-    const u32 ppuSteps = totalPhase / ppuDen;
-    main->ppuPhaseAcc = totalPhase % ppuDen;
-
-    for (u32 ppuStep = 0; ppuStep < ppuSteps; ++ppuStep) {
-        main->ppu->r.step();
-
-        if (main->ppu->r.nmiPending()) {
-            main->cpu->c.do_nmi = true;
-            main->ppu->r.clearNmi();
-        }
-    }
-
-    main->apu->step(cycles);
-
-    const auto &apuState = main->apu->getState();
-    if (main->mapper->irqFlag || apuState.frameIrq || apuState.dmc.irqFlag)
-        main->cpu->c.do_irq = true;
+    main->console.runInstruction();
+    main->console.sync();
 }
 
 void WUpdate::presentAudioAndVideo() {
     if (!main)
         return;
 
-    if (main->audio && main->apu && !main->apu->samples.empty()) {
-        main->audio->pushSamples(main->apu->samples);
-        main->apu->samples.clear();
+    const auto &console = main->console;
+
+    if (main->audio && console.apu && !console.apu->samples.empty()) {
+        main->audio->pushSamples(console.apu->samples);
+        console.apu->samples.clear();
     }
 
-    if (main->ui && main->ppu && main->ui->frameView)
-        main->ui->frameView->setFrameBuffer(main->ppu->frame);
+    if (main->ui && console.ppu && main->ui->frameView)
+        main->ui->frameView->setFrameBuffer(console.ppu->indexFrame);
 }
 
 auto WUpdate::ppuPerCpu() const -> f64 {
@@ -34,7 +34,7 @@ private:
 
     void startEmuWorker();
     void stopEmuWorker();
-    void emulateFrameCore();
+    void emulateFrameCore(bool present = true);
     auto applyReadyEmuFrame() -> bool;
     void syncDbgSafe();
 
@@ -59,6 +59,22 @@ auto firstNesPath(const QMimeData *mime) -> QString {
     return {};
 }
 
+/* Папка mappers/ рядом с программой, уровнем выше или в текущей */
+auto mapperDirectory() -> std::filesystem::path {
+    const QStringList dirs = {
+        QDir::cleanPath(QCoreApplication::applicationDirPath() + "/mappers"),
+        QDir::cleanPath(QCoreApplication::applicationDirPath() +
+                        "/../mappers"),
+        QDir::cleanPath(QDir::currentPath() + "/mappers")};
+
+    for (const QString &dir : dirs) {
+        if (QDir(dir).exists())
+            return dir.toStdWString();
+    }
+
+    return "mappers/";
+}
+
 void setDirMask(u8 &state, u8 mask) {
     if (mask == 0x80)
         state &= static_cast<u8>(~0x40);
@@ -124,7 +140,16 @@ WMain::WMain(const QString &romPath, QWidget *p)
         loadRom(romPath);
 }
 
-WMain::~WMain() = default;
+WMain::~WMain() {
+    /* Идущая запись не теряется при закрытии окна */
+    if (movie && movieRecording) {
+        UpdateCriticalGuard guard(updater.get());
+        try {
+            movie->save(toFsPath(moviePath));
+        } catch (const std::exception &) {
+        }
+    }
+}
 
 void WMain::dragEnterEvent(QDragEnterEvent *event) {
     if (firstNesPath(event->mimeData()).isEmpty()) {
@@ -267,11 +292,8 @@ void WMain::setAudioVolume(int volumePercent) {
 }
 
 void WMain::syncJoypad() {
-    if (!mem)
-        return;
-
-    mem->setJoy1(joyState);
-    mem->setJoy2(joyStateP2);
+    console.setJoy1(joyState);
+    console.setJoy2(joyStateP2);
 }
 
 void WMain::stpMenuActions() {
@@ -307,6 +329,95 @@ void WMain::stpMenuActions() {
     bindRegion(ui->actionRegionPAL, Core::PPU::Region::PAL);
     bindRegion(ui->actionRegionDendy, Core::PPU::Region::DENDY);
 
+    auto *runAhead = new QActionGroup(this);
+    runAhead->setExclusive(true);
+    runAhead->addAction(ui->actionRunAheadOff);
+    runAhead->addAction(ui->actionRunAhead1);
+    runAhead->addAction(ui->actionRunAhead2);
+    runAhead->addAction(ui->actionRunAhead3);
+
+    const auto bindRunAhead = [this](QAction *a, u32 frames) {
+        connect(a, &QAction::toggled, this, [this, frames](bool checked) {
+            if (checked)
+                runAheadFrames.store(frames);
+        });
+    };
+
+    bindRunAhead(ui->actionRunAheadOff, 0);
+    bindRunAhead(ui->actionRunAhead1, 1);
+    bindRunAhead(ui->actionRunAhead2, 2);
+    bindRunAhead(ui->actionRunAhead3, 3);
+
+    connect(ui->actionFastForward, &QAction::toggled, this,
+            [this](bool checked) {
+                fastForward = checked;
+                if (updater)
+                    updater->updWindowTitle();
+            });
+
+    connect(ui->actionRewind, &QAction::toggled, this, [this](bool checked) {
+        rewinding = checked;
+        if (updater)
+            updater->updWindowTitle();
+    });
+
+    auto *speed = new QActionGroup(this);
+    speed->setExclusive(true);
+    speed->addAction(ui->actionSpeed2x);
+    speed->addAction(ui->actionSpeed4x);
+    speed->addAction(ui->actionSpeed8x);
+    speed->addAction(ui->actionSpeedUncapped);
+
+    const auto bindSpeed = [this](QAction *a, u32 frames) {
+        connect(a, &QAction::toggled, this, [this, frames](bool checked) {
+            if (checked)
+                fastForwardSpeed = frames;
+        });
+    };
+
+    bindSpeed(ui->actionSpeed2x, 2);
+    bindSpeed(ui->actionSpeed4x, 4);
+    bindSpeed(ui->actionSpeed8x, 8);
+    bindSpeed(ui->actionSpeedUncapped, 0);
+
+    connect(ui->actionMovieRecord, &QAction::triggered, this, [this]() {
+        if (!romLoaded || !console.isLoaded())
+            return;
+
+        /* С включения (ROM перезагружается) или со снимка текущей игры */
+        const auto answer = QMessageBox::question(
+            this, tr("Record Movie"),
+            tr("Record from power-on? The ROM will be reloaded.\n"
+               "Choose No to record from the current state."),
+            QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+        if (answer == QMessageBox::Cancel)
+            return;
+
+        const QString path = QFileDialog::getSaveFileName(
+            this, tr("Record Movie"), QString(),
+            tr("NES Movie (*.nmv);;All files (*.*)"));
+
+        if (!path.isEmpty())
+            recordMovie(path, (answer == QMessageBox::Yes)
+                                  ? Core::Movie::Start::POWER_ON
+                                  : Core::Movie::Start::SNAPSHOT);
+    });
+
+    connect(ui->actionMoviePlay, &QAction::triggered, this, [this]() {
+        if (!romLoaded || !console.isLoaded())
+            return;
+
+        const QString path = QFileDialog::getOpenFileName(
+            this, tr("Play Movie"), QString(),
+            tr("NES Movie (*.nmv);;All files (*.*)"));
+
+        if (!path.isEmpty())
+            playMovie(path);
+    });
+
+    connect(ui->actionMovieStop, &QAction::triggered, this,
+            &WMain::stopMovie);
+
     connect(ui->actionOpen_ROM, &QAction::triggered, this, [this]() {
         const QString path = QFileDialog::getOpenFileName(
             this, tr("Open NES ROM"), QString(),
@@ -353,17 +464,17 @@ void WMain::stpMenuActions() {
     connect(ui->actionReset, &QAction::triggered, this, [this]() {
         UpdateCriticalGuard guard(updater.get());
 
-        if (cpu)
-            cpu->reset();
-        if (apu)
-            apu->reset();
+        stopNetplay();
+        stopMovie();
+        console.reset();
+        rewind.clear();
         joyState = 0;
         joyStateP2 = 0;
         syncJoypad();
     });
 
     connect(ui->actionSave, &QAction::triggered, this, [this]() {
-        if (!romLoaded || !cpu || !ppu || !apu || !mem || !mapper)
+        if (!romLoaded || !console.isLoaded())
             return;
 
         UpdateCriticalGuard guard(updater.get());
@@ -375,21 +486,17 @@ void WMain::stpMenuActions() {
         if (path.isEmpty())
             return;
 
-        const u8 regionCode =
-            static_cast<u8>(emuRegion == Core::PPU::Region::PAL     ? 1
-                            : emuRegion == Core::PPU::Region::DENDY ? 2
-                                                                    : 0);
+        std::vector<u8> snapshot;
+        console.saveSnapshot(snapshot);
 
-        if (!saveBinState(path, cpu->getState(), ppu->getState(),
-                          apu->getState(), mem->getState(), mapper->getState(),
-                          regionCode)) {
+        if (!saveBinState(path, snapshot)) {
             QMessageBox::warning(this, tr("Save State"),
                                  tr("Failed to save state to file."));
         }
     });
 
     connect(ui->actionLoad, &QAction::triggered, this, [this]() {
-        if (!romLoaded || !cpu || !ppu || !apu || !mem || !mapper)
+        if (!romLoaded || !console.isLoaded())
             return;
 
         UpdateCriticalGuard guard(updater.get());
@@ -401,50 +508,44 @@ void WMain::stpMenuActions() {
         if (path.isEmpty())
             return;
 
-        Core::CPU::State cpuState{};
-        Core::PPU::State ppuState{};
-        Core::APU::State apuState{};
-        Core::Memory::State memState{};
-        Core::Mapper::State mapperState{};
-        u8 regionState = 0;
+        std::vector<u8> snapshot;
+        Core::SaveState state;
 
-        if (!loadBinState(path, cpuState, ppuState, apuState, memState,
-                          mapperState, regionState)) {
+        if (!loadBinState(path, snapshot, state)) {
             QMessageBox::warning(this, tr("Load State"),
                                  tr("Failed to load state from file."));
             return;
         }
 
-        try {
-            if (!currRomPath.isEmpty())
-                mapper->loadNES(toFsPath(currRomPath));
-
-            if (mapper->mapperNumber != mapperState.mapperNumber) {
-                QMessageBox::warning(
-                    this, tr("Load State"),
-                    tr("Mapper number mismatch. State file was created "
-                       "with a different mapper."));
-                return;
-            }
-
-            mapper->loadState(mapperState);
-            cpu->loadState(cpuState);
-            ppu->loadState(ppuState);
-            apu->loadState(apuState);
-            mem->loadState(memState);
+        if (console.mapper->mapperNumber != state.mapper.mapperNumber) {
+            QMessageBox::warning(this, tr("Load State"),
+                                 tr("Mapper number mismatch. State file was "
+                                    "created with a different mapper."));
+            return;
+        }
 
-            switch (regionState) {
-            case 1:
-                applyRegion(Core::PPU::Region::PAL);
+        try {
+            stopNetplay();
+            stopMovie();
+
+            /* Меню региона переключает и консоль; смена региона
+             * сбрасывает часы планировщика, поэтому до снимка */
+            switch (static_cast<Core::PPU::Region>(state.region)) {
+            case Core::PPU::Region::PAL:
+                ui->actionRegionPAL->setChecked(true);
                 break;
-            case 2:
-                applyRegion(Core::PPU::Region::DENDY);
+            case Core::PPU::Region::DENDY:
+                ui->actionRegionDendy->setChecked(true);
                 break;
             default:
-                applyRegion(Core::PPU::Region::NTSC);
+                ui->actionRegionNTSC->setChecked(true);
                 break;
             }
 
+            /* Весь снимок разом, вместе с тактом планировщика */
+            console.loadSnapshot(snapshot);
+            rewind.clear();
+
             if (audio)
                 audio->reset();
 
@@ -533,14 +634,13 @@ void WMain::clearCore() {
     if (ui && ui->frameView)
         ui->frameView->clear();
 
-    cpu.reset();
-    apu.reset();
-    mem.reset();
-    ppu.reset();
+    stopNetplay();
+    stopMovie();
+    console.unload();
+    rewind.clear();
 
     joyState = 0;
     joyStateP2 = 0;
-    ppuPhaseAcc = 0;
     romLoaded = false;
     paused = false;
 
@@ -573,41 +673,11 @@ void WMain::loadRom(const QString &romPath) {
     try {
         clearCore();
 
-        if (!mapper)
-            mapper = std::make_unique<Core::Mapper>();
-
-        mapper->loadNES(toFsPath(romPath));
-
-        std::filesystem::path mapperDir;
-        const QStringList dirs = {
-            QDir::cleanPath(QCoreApplication::applicationDirPath() +
-                            "/mappers"),
-            QDir::cleanPath(QCoreApplication::applicationDirPath() +
-                            "/../mappers"),
-            QDir::cleanPath(QDir::currentPath() + "/mappers")};
-
-        for (const QString &dir : dirs) {
-            if (QDir(dir).exists()) {
-                mapperDir = dir.toStdWString();
-                break;
-            }
-        }
-
-        if (mapperDir.empty())
-            mapper->load();
-        else
-            mapper->load(mapperDir);
-
-        ppu = std::make_unique<Core::PPU>(mapper.get());
-        ppu->setRegion(emuRegion);
+        console.setRegion(emuRegion);
+        console.loadRom(toFsPath(romPath), mapperDirectory());
 
-        apu = std::make_unique<Core::APU>();
-        apu->powerUp();
-
-        apu->cyclesPerSample =
-            (emuRegion == Core::PPU::Region::PAL)     ? Core::APU::PAL_CYCLES
-            : (emuRegion == Core::PPU::Region::DENDY) ? Core::APU::DENDY_CYCLES
-                                                      : Core::APU::NTSC_CYCLES;
+        /* RGB получается только при показе кадра (WFrame) */
+        console.ppu->indexedOutput = true;
 
         if (!audio)
             audio = std::make_unique<NesAudio>();
@@ -616,11 +686,6 @@ void WMain::loadRom(const QString &romPath) {
         audio->setVolume(static_cast<f32>(audioVolume) / 100.0f);
         audio->reset();
 
-        mem =
-            std::make_unique<Core::Memory>(mapper.get(), ppu.get(), apu.get());
-        cpu = std::make_unique<Core::CPU>(mem.get());
-        cpu->reset();
-
         currRomPath = romPath;
         romLoaded = true;
         paused = false;
@@ -633,7 +698,7 @@ void WMain::loadRom(const QString &romPath) {
             ui->actionPause->setChecked(false);
 
         if (ui->frameView)
-            ui->frameView->setFrameBuffer(ppu->frame);
+            ui->frameView->setFrameBuffer(console.ppu->indexFrame);
 
 #if defined(DEBUG)
         resetLogsUi();
@@ -657,21 +722,210 @@ void WMain::loadRom(const QString &romPath) {
     }
 }
 
-void WMain::applyRegion(Core::PPU::Region region) {
+bool WMain::powerOn(const QString &title) {
     UpdateCriticalGuard guard(updater.get());
 
-    emuRegion = region;
+    try {
+        console.setRegion(emuRegion);
+        console.loadRom(toFsPath(currRomPath), mapperDirectory());
+        console.ppu->indexedOutput = true;
+        rewind.clear();
+    } catch (const std::exception &e) {
+        clearCore();
+        QMessageBox::warning(this, title,
+                             tr("Failed to reload ROM:\n%1")
+                                 .arg(QString::fromLocal8Bit(e.what())));
+        return false;
+    }
+
+    syncJoypad();
+
+    if (audio)
+        audio->reset();
+    if (ui->frameView)
+        ui->frameView->setFrameBuffer(console.ppu->indexFrame);
+    return true;
+}
+
+bool WMain::startNetplay(u8 player, u16 localPort, const QString &host,
+                         u16 remotePort, u32 inputDelay) {
+    if (!romLoaded || !console.isLoaded())
+        return false;
+
+    UpdateCriticalGuard guard(updater.get());
+
+    stopNetplay();
+    stopMovie();
+
+    /* Оба собеседника начинают с включения, сколько бы кадров ни успел
+     * прогнать поток эмуляции */
+    if (!powerOn(tr("Netplay")))
+        return false;
+
+    try {
+        netTransport = std::make_unique<Core::UdpTransport>(
+            localPort, host.toStdString(), remotePort);
+
+        Core::Netplay::Config config;
+        config.localPlayer = player;
+        config.inputDelay = inputDelay;
+        netplay = std::make_unique<Core::Netplay>(console, *netTransport,
+                                                  config);
+    } catch (const std::exception &e) {
+        netplay.reset();
+        netTransport.reset();
+        QMessageBox::warning(this, tr("Netplay"),
+                             tr("Failed to start netplay:\n%1")
+                                 .arg(QString::fromLocal8Bit(e.what())));
+        return false;
+    }
+
+    if (updater)
+        updater->updWindowTitle();
+    return true;
+}
+
+void WMain::stopNetplay() {
+    netplay.reset();
+    netTransport.reset();
+}
+
+void WMain::recordMovie(const QString &path, Core::Movie::Start start) {
+    if (!romLoaded || !console.isLoaded())
+        return;
+
+    UpdateCriticalGuard guard(updater.get());
+
+    stopMovie();
+
+    if (netplay) {
+        QMessageBox::warning(this, tr("Record Movie"),
+                             tr("Movies are not available during netplay."));
+        return;
+    }
+
+    if (start == Core::Movie::Start::POWER_ON && !powerOn(tr("Record Movie")))
+        return;
+
+    try {
+        auto rec = std::make_unique<Core::Movie>();
+        rec->startRecording(console, start,
+                            Core::Movie::hashRom(toFsPath(currRomPath)));
+        movie = std::move(rec);
+        moviePath = path;
+        movieRecording = true;
+    } catch (const std::exception &e) {
+        QMessageBox::warning(this, tr("Record Movie"),
+                             tr("Failed to start recording:\n%1")
+                                 .arg(QString::fromLocal8Bit(e.what())));
+    }
+
+    if (updater)
+        updater->updWindowTitle();
+}
+
+bool WMain::playMovie(const QString &path) {
+    if (!romLoaded || !console.isLoaded())
+        return false;
+
+    UpdateCriticalGuard guard(updater.get());
+
+    stopMovie();
 
-    if (ppu)
-        ppu->setRegion(region);
+    if (netplay) {
+        QMessageBox::warning(this, tr("Play Movie"),
+                             tr("Movies are not available during netplay."));
+        return false;
+    }
+
+    auto play = std::make_unique<Core::Movie>();
+    try {
+        play->load(toFsPath(path));
+    } catch (const std::exception &e) {
+        QMessageBox::warning(this, tr("Play Movie"),
+                             tr("Failed to load movie:\n%1")
+                                 .arg(QString::fromLocal8Bit(e.what())));
+        return false;
+    }
+
+    if (play->getRomHash() != Core::Movie::hashRom(toFsPath(currRomPath)))
+        QMessageBox::warning(this, tr("Play Movie"),
+                             tr("The movie was recorded with a different "
+                                "ROM and may desync."));
+
+    /* Меню региона переключает и консоль */
+    switch (play->getRegion()) {
+    case Core::PPU::Region::PAL:
+        ui->actionRegionPAL->setChecked(true);
+        break;
+    case Core::PPU::Region::DENDY:
+        ui->actionRegionDendy->setChecked(true);
+        break;
+    default:
+        ui->actionRegionNTSC->setChecked(true);
+        break;
+    }
+
+    /* Запись с включения: ROM перезагружается в уже выбранном регионе */
+    if (play->getStart() == Core::Movie::Start::POWER_ON &&
+        !powerOn(tr("Play Movie")))
+        return false;
+
+    try {
+        play->startPlayback(console);
+    } catch (const std::exception &e) {
+        QMessageBox::warning(this, tr("Play Movie"),
+                             tr("Failed to start playback:\n%1")
+                                 .arg(QString::fromLocal8Bit(e.what())));
+        return false;
+    }
+
+    movie = std::move(play);
+    moviePath = path;
+    movieRecording = false;
+
+    if (audio)
+        audio->reset();
+    if (updater)
+        updater->updWindowTitle();
+    return true;
+}
 
-    if (apu) {
-        apu->cyclesPerSample =
-            (region == Core::PPU::Region::PAL)     ? Core::APU::PAL_CYCLES
-            : (region == Core::PPU::Region::DENDY) ? Core::APU::DENDY_CYCLES
-                                                   : Core::APU::NTSC_CYCLES;
+void WMain::stopMovie() {
+    if (!movie)
+        return;
+
+    UpdateCriticalGuard guard(updater.get());
+
+    if (movieRecording) {
+        try {
+            movie->save(toFsPath(moviePath));
+        } catch (const std::exception &e) {
+            QMessageBox::warning(this, tr("Record Movie"),
+                                 tr("Failed to save movie:\n%1")
+                                     .arg(QString::fromLocal8Bit(e.what())));
+        }
     }
 
+    movie.reset();
+    moviePath.clear();
+    movieRecording = false;
+
+    if (updater)
+        updater->updWindowTitle();
+}
+
+void WMain::applyRegion(Core::PPU::Region region) {
+    UpdateCriticalGuard guard(updater.get());
+
+    emuRegion = region;
+
+    /* Другой регион - другие кадры у собеседника и в записи */
+    stopNetplay();
+    stopMovie();
+    console.setRegion(region);
+    rewind.clear();
+
     if (updater)
         updater->updFrameCap();
 
@@ -6,13 +6,15 @@
 #include <QString>
 #include <QTimer>
 
+#include <atomic>
+
 #include "common/types.h"
 
-#include "core/apu.h"
-#include "core/cpu.h"
-#include "core/mapper.h"
-#include "core/mem.h"
-#include "core/ppu.h"
+#include "core/console.h"
+#include "core/movie.h"
+#include "core/netplay.h"
+#include "core/rewind.h"
+#include "core/transport.h"
 
 class QDragEnterEvent;
 class QDropEvent;
@@ -45,6 +47,20 @@ public:
     void setAudioEnabled(bool enabled);
     void setAudioVolume(int volumePercent);
 
+    /* Сетевая игра с включения консоли (ROM перезагружается): свой
+     * джойпад (клавиши P1) идёт за игрока player (0 или 1), собеседник -
+     * host:remotePort */
+    bool startNetplay(u8 player, u16 localPort, const QString &host,
+                      u16 remotePort, u32 inputDelay);
+    void stopNetplay();
+
+    /* Запись ввода (Core::Movie): с включения (ROM перезагружается) или
+     * со снимка текущего состояния. Запись с включения и проигрывается с
+     * перезагрузки. stopMovie() сохраняет идущую запись */
+    void recordMovie(const QString &path, Core::Movie::Start start);
+    bool playMovie(const QString &path);
+    void stopMovie();
+
 protected:
     void dragEnterEvent(QDragEnterEvent *event) override;
     void dropEvent(QDropEvent *event) override;
@@ -61,6 +77,8 @@ private:
 #endif
     void clearCore();
     void loadRom(const QString &romPath);
+    /* Перезагрузка открытого ROM: консоль как после включения */
+    bool powerOn(const QString &title);
     void applyRegion(Core::PPU::Region region);
     void syncJoypad();
     void resetDefaultBindings();
@@ -69,11 +87,7 @@ private:
 private:
     std::unique_ptr<Ui::MainWindow> ui;
 
-    std::unique_ptr<Core::Mapper> mapper;
-    std::unique_ptr<Core::PPU> ppu;
-    std::unique_ptr<Core::APU> apu;
-    std::unique_ptr<Core::Memory> mem;
-    std::unique_ptr<Core::CPU> cpu;
+    Core::Console console;
     std::unique_ptr<NesAudio> audio;
     std::unique_ptr<WUpdate> updater;
     std::unique_ptr<WSettings> settingsWindow;
@@ -86,7 +100,6 @@ private:
 
     qsizetype fpsUpdate{0};
     f64 currFps{0.0};
-    u32 ppuPhaseAcc{0};
 
     QString currRomPath;
     Core::PPU::Region emuRegion{Core::PPU::Region::NTSC};
@@ -101,6 +114,29 @@ private:
     bool audioEnabled{true};
     int audioVolume{100};
 
+    /* Кадров run-ahead (0 - выключено), см. Console::runFrameAhead.
+     * Меняется в GUI, читается потоком эмуляции */
+    std::atomic<u32> runAheadFrames{0};
+
+    /* Перемотка: fastForwardSpeed кадров эмуляции на показанный,
+     * 0 - без ограничения (см. WUpdate::emuWorkerTick) */
+    bool fastForward{false};
+    u32 fastForwardSpeed{4};
+
+    /* Перемотка назад: пока rewinding, кадры идут из кольца снимков.
+     * Кольцо пополняется каждым кадром вне netplay и записи ввода */
+    Core::Rewind rewind;
+    bool rewinding{false};
+
+    /* Сессия netplay; run-ahead в ней не используется */
+    std::unique_ptr<Core::Transport> netTransport;
+    std::unique_ptr<Core::Netplay> netplay;
+
+    /* Запись или проигрывание ввода; в netplay не используется */
+    std::unique_ptr<Core::Movie> movie;
+    QString moviePath;
+    bool movieRecording{false};
+
     bool romLoaded{false};
     bool paused{false};
 };
@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "core/statehash.h"
+
+/* Сравнение двух потоков хэшей (nespp-headless --hash-log): первый кадр,
+ * на котором прогоны разошлись, и части состояния, которые разошлись.
+ * Код возврата: 0 - совпадают, 1 - разошлись, 2 - ошибка.
+ */
+namespace {
+struct Stream {
+    std::ifstream file;
+    std::string path;
+    u64 line{0};
+
+    /* false - конец файла; битая строка - исключение */
+    bool next(u64 &frame, Core::StateHash &hash) {
+        std::string text;
+        while (std::getline(file, text)) {
+            ++line;
+            if (text.empty())
+                continue;
+            if (!Core::HashLog::parse(text, frame, hash))
+                throw std::runtime_error("[HASH]: " + path + ":" +
+                                         std::to_string(line) +
+                                         ": битая строка");
+            return true;
+        }
+        return false;
+    }
+};
+} /* namespace */
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        std::fprintf(stderr, "Usage: %s <a.log> <b.log>\n", argv[0]);
+        return 2;
+    }
+
+    Stream a{std::ifstream(argv[1]), argv[1]};
+    Stream b{std::ifstream(argv[2]), argv[2]};
+    if (!a.file || !b.file) {
+        std::fprintf(stderr, "[HASH]: Не удалось открыть %s\n",
+                     !a.file ? argv[1] : argv[2]);
+        return 2;
+    }
+
+    try {
+        u64 frames = 0;
+        for (;;) {
+            u64 fa = 0;
+            u64 fb = 0;
+            Core::StateHash ha;
+            Core::StateHash hb;
+            const bool moreA = a.next(fa, ha);
+            const bool moreB = b.next(fb, hb);
+
+            if (!moreA && !moreB) {
+                std::printf("identical: %llu frames\n",
+                            static_cast<unsigned long long>(frames));
+                return 0;
+            }
+
+            if (!moreA || !moreB) {
+                std::printf("%s ends after %llu frames\n",
+                            !moreA ? a.path.c_str() : b.path.c_str(),
+                            static_cast<unsigned long long>(frames));
+                return 1;
+            }
+
+            if (fa != fb) {
+                std::printf("frame numbers differ: %llu vs %llu\n",
+                            static_cast<unsigned long long>(fa),
+                            static_cast<unsigned long long>(fb));
+                return 1;
+            }
+
+            if (ha != hb) {
+                std::printf("first divergence at frame %llu:",
+                            static_cast<unsigned long long>(fa));
+                for (sz i = 0; i < Core::StateHash::COUNT; ++i) {
+                    if (ha.parts[i] != hb.parts[i])
+                        std::printf(" %s", Core::StateHash::partName(i));
+                }
+                std::printf("\n");
+                return 1;
+            }
+
+            ++frames;
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 2;
+    }
+}
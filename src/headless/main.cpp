@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/pool.h"
+
+#include "core/console.h"
+#include "core/movie.h"
+
+namespace {
+void printUsage(const char *exe) {
+    std::fprintf(stderr,
+                 "Usage: %s <rom.nes>... [frames] [--mappers <dir>] "
+                 "[--region ntsc|pal|dendy] [--dot-renderer] [--lua-mappers] "
+                 "[--jobs N] [--chunk F] [--hash-log file] "
+                 "[--movie file]\n",
+                 exe);
+}
+
+auto findMapperDir(const char *argv0) -> std::filesystem::path {
+    std::error_code ec;
+    const std::filesystem::path exeDir =
+        std::filesystem::absolute(argv0, ec).parent_path();
+
+    const std::vector<std::filesystem::path> dirs = {
+        exeDir / "mappers", exeDir / ".." / "mappers",
+        std::filesystem::current_path(ec) / "mappers"};
+
+    for (const auto &dir : dirs) {
+        if (std::filesystem::is_directory(dir, ec))
+            return dir.lexically_normal();
+    }
+
+    return "mappers/";
+}
+
+auto parseRegion(const std::string &name, Core::PPU::Region &region) -> bool {
+    if (name == "ntsc")
+        region = Core::PPU::Region::NTSC;
+    else if (name == "pal")
+        region = Core::PPU::Region::PAL;
+    else if (name == "dendy")
+        region = Core::PPU::Region::DENDY;
+    else
+        return false;
+
+    return true;
+}
+auto isNumber(const std::string &s) -> bool {
+    return !s.empty() &&
+           std::all_of(s.begin(), s.end(), [](char ch) {
+               return std::isdigit(static_cast<unsigned char>(ch)) != 0;
+           });
+}
+
+struct Options {
+    std::filesystem::path mapperDir;
+    std::filesystem::path hashLog; /* только для одного ROM без пула */
+    std::filesystem::path movie;   /* тоже */
+    Core::PPU::Region region{Core::PPU::Region::NTSC};
+    u64 frames{600};
+    u64 chunk{0}; /* кадров на задачу; 0 - все кадры одной задачей */
+    u32 jobs{0};
+    bool dotRenderer{false};
+    bool luaMappers{false};
+};
+
+auto loadConsole(Core::Console &console, const std::filesystem::path &rom,
+                 const Options &opt) -> void {
+    console.setRegion(opt.region);
+    console.luaMappers = opt.luaMappers;
+    console.loadRom(rom, opt.mapperDir);
+    console.ppu->scanlineRenderer = !opt.dotRenderer;
+
+    /* Кадр не показывается: пиксели не нужны (sprite-0 hit и тайминги
+     * PPU от этого не меняются) */
+    console.ppu->indexedOutput = true;
+    console.ppu->skipOutput = true;
+}
+
+/* Пакетный прогон: задачи "консоль K, следующие chunk кадров" раздаются
+ * пулу; консоль K закреплена за одним потоком пула */
+auto runBatch(const std::vector<std::filesystem::path> &roms,
+              const Options &opt) -> int {
+    struct Instance {
+        Core::Console console;
+        u64 frames{0};
+        f64 seconds{0.0};
+        std::string error;
+    };
+
+    std::vector<std::unique_ptr<Instance>> instances;
+    for (const auto &rom : roms) {
+        auto inst = std::make_unique<Instance>();
+        try {
+            loadConsole(inst->console, rom, opt);
+        } catch (const std::exception &e) {
+            inst->error = e.what();
+        }
+        instances.push_back(std::move(inst));
+    }
+
+    Common::Thread::WorkPool pool(opt.jobs);
+    std::vector<Common::Thread::WorkPool::TaskStats> stats;
+
+    const u64 chunk = (opt.chunk != 0) ? opt.chunk : opt.frames;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (u64 done = 0; done < opt.frames; done += chunk) {
+        const u64 count = std::min(chunk, opt.frames - done);
+
+        for (sz k = 0; k < instances.size(); ++k) {
+            Instance *inst = instances[k].get();
+            if (!inst->error.empty())
+                continue;
+
+            /* Ошибка ROM-а остаётся в его строке отчёта и не прерывает
+             * остальные экземпляры (pool.wait() пробросил бы её) */
+            pool.submit(
+                [inst, count]() {
+                    const auto t0 = std::chrono::steady_clock::now();
+                    try {
+                        for (u64 i = 0; i < count; ++i) {
+                            if (!inst->console.runFrame()) {
+                                inst->error = "[RUN]: CPU застрял на кадре " +
+                                              std::to_string(inst->frames);
+                                break;
+                            }
+                            inst->console.apu->samples.clear();
+                            ++inst->frames;
+                        }
+                    } catch (const std::exception &e) {
+                        inst->error = e.what();
+                    }
+                    inst->seconds += std::chrono::duration<f64>(
+                                         std::chrono::steady_clock::now() - t0)
+                                         .count();
+                },
+                static_cast<u32>(k));
+        }
+
+        pool.wait();
+        const auto round = pool.takeStats();
+        stats.insert(stats.end(), round.begin(), round.end());
+    }
+
+    const f64 sec = std::chrono::duration<f64>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+    int status = EXIT_SUCCESS;
+    u64 totalFrames = 0;
+    for (sz k = 0; k < instances.size(); ++k) {
+        const Instance &inst = *instances[k];
+        totalFrames += inst.frames;
+
+        const f64 fps =
+            (inst.seconds > 0.0) ? static_cast<f64>(inst.frames) / inst.seconds
+                                 : 0.0;
+        std::printf("%s: frames %llu, fps %.1f%s%s\n", roms[k].string().c_str(),
+                    static_cast<unsigned long long>(inst.frames), fps,
+                    inst.error.empty() ? "" : ", ", inst.error.c_str());
+        if (!inst.error.empty())
+            status = EXIT_FAILURE;
+    }
+
+    f64 waitSum = 0.0;
+    f64 waitMax = 0.0;
+    f64 runSum = 0.0;
+    f64 runMax = 0.0;
+    sz stolen = 0;
+    for (const auto &t : stats) {
+        waitSum += t.waitSec;
+        waitMax = std::max(waitMax, t.waitSec);
+        runSum += t.runSec;
+        runMax = std::max(runMax, t.runSec);
+        stolen += t.stolen ? 1 : 0;
+    }
+    const f64 tasks = static_cast<f64>(std::max<sz>(stats.size(), 1));
+
+    std::printf("threads: %u\ntasks: %zu (stolen %zu)\n", pool.size(),
+                stats.size(), stolen);
+    std::printf("task wait: avg %.3f ms, max %.3f ms\n",
+                waitSum / tasks * 1e3, waitMax * 1e3);
+    std::printf("task run: avg %.3f ms, max %.3f ms\n", runSum / tasks * 1e3,
+                runMax * 1e3);
+    std::printf("time: %.3f s\ntotal fps: %.1f\n", sec,
+                (sec > 0.0) ? static_cast<f64>(totalFrames) / sec : 0.0);
+    return status;
+}
+} /* namespace */
+
+int main(int argc, char *argv[]) {
+    std::vector<std::filesystem::path> roms;
+    Options opt;
+    bool batch = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+
+        if (arg == "--mappers" && i + 1 < argc) {
+            opt.mapperDir = argv[++i];
+        } else if (arg == "--region" && i + 1 < argc) {
+            if (!parseRegion(argv[++i], opt.region)) {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--dot-renderer") {
+            opt.dotRenderer = true;
+        } else if (arg == "--lua-mappers") {
+            opt.luaMappers = true;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            opt.jobs = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+            batch = true;
+        } else if (arg == "--hash-log" && i + 1 < argc) {
+            opt.hashLog = argv[++i];
+        } else if (arg == "--movie" && i + 1 < argc) {
+            opt.movie = argv[++i];
+        } else if (arg == "--chunk" && i + 1 < argc) {
+            opt.chunk = std::strtoull(argv[++i], nullptr, 10);
+            batch = true;
+        } else if (isNumber(arg) && !roms.empty()) {
+            opt.frames = std::strtoull(arg.c_str(), nullptr, 10);
+        } else {
+            roms.emplace_back(arg);
+        }
+    }
+
+    if (roms.empty()) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt.mapperDir.empty())
+        opt.mapperDir = findMapperDir(argv[0]);
+
+    if (batch || roms.size() > 1) {
+        if (!opt.hashLog.empty() || !opt.movie.empty())
+            std::fprintf(stderr, "--hash-log и --movie работают только для "
+                                 "одного ROM без --jobs/--chunk\n");
+        return runBatch(roms, opt);
+    }
+
+    u64 frames = opt.frames;
+    Core::Console console;
+    std::unique_ptr<Core::HashLog> hashLog;
+    std::unique_ptr<Core::Movie> movie;
+
+    try {
+        if (!opt.movie.empty()) {
+            movie = std::make_unique<Core::Movie>();
+            movie->load(opt.movie);
+            opt.region = movie->getRegion();
+        }
+
+        loadConsole(console, roms.front(), opt);
+        if (!opt.hashLog.empty())
+            hashLog = std::make_unique<Core::HashLog>(opt.hashLog);
+
+        /* Запись проигрывается целиком и без пауз между кадрами */
+        if (movie) {
+            if (movie->getRomHash() != Core::Movie::hashRom(roms.front()))
+                std::fprintf(stderr, "[MOVIE]: Запись сделана с другим "
+                                     "ROM, кадры могут не совпасть\n");
+            movie->startPlayback(console);
+            frames = movie->frames();
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    try {
+        for (u64 i = 0; i < frames; ++i) {
+            u8 joy1 = 0;
+            u8 joy2 = 0;
+            if (movie && movie->next(joy1, joy2)) {
+                console.setJoy1(joy1);
+                console.setJoy2(joy2);
+            }
+
+            if (!console.runFrame()) {
+                std::fprintf(stderr, "[RUN]: CPU застрял на кадре %llu\n",
+                             static_cast<unsigned long long>(i));
+                return EXIT_FAILURE;
+            }
+
+            /* Звук в headless режиме не нужен */
+            console.apu->samples.clear();
+
+            if (hashLog)
+                hashLog->write(console.getFrameCount(), console.stateHash());
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    const f64 sec = std::chrono::duration<f64>(clock::now() - start).count();
+    const f64 fps = (sec > 0.0) ? static_cast<f64>(frames) / sec : 0.0;
+
+    std::printf("frames: %llu\ntime: %.3f s\nfps: %.1f\n",
+                static_cast<unsigned long long>(frames), sec, fps);
+    return EXIT_SUCCESS;
+}
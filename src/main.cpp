@@ -3,16 +3,60 @@
 
 #include "gui/w_main.h"
 
+/* nespp [rom.nes] [--netplay <1|2> <localPort> <host:port>]
+ *       [--input-delay N] [--movie file] [--record-movie file] */
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
 
     QString romPath;
+    QString netPeer;
+    int netPlayer = 0;
+    int netPort = 0;
+    int inputDelay = 1;
+    QString playPath;
+    QString recordPath;
+
     const QStringList args = QCoreApplication::arguments();
-    if (args.size() > 1)
-        romPath = args.at(1);
+    for (qsizetype i = 1; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+
+        if (arg == QStringLiteral("--netplay") && i + 3 < args.size()) {
+            netPlayer = args.at(++i).toInt();
+            netPort = args.at(++i).toInt();
+            netPeer = args.at(++i);
+        } else if (arg == QStringLiteral("--input-delay") &&
+                   i + 1 < args.size()) {
+            inputDelay = args.at(++i).toInt();
+        } else if (arg == QStringLiteral("--movie") && i + 1 < args.size()) {
+            playPath = args.at(++i);
+        } else if (arg == QStringLiteral("--record-movie") &&
+                   i + 1 < args.size()) {
+            recordPath = args.at(++i);
+        } else {
+            romPath = arg;
+        }
+    }
 
     WMain mainWindow(romPath);
     mainWindow.show();
 
+    if (!netPeer.isEmpty()) {
+        const qsizetype colon = netPeer.lastIndexOf(':');
+        const QString host = netPeer.left(colon);
+        const int remotePort = netPeer.mid(colon + 1).toInt();
+
+        if (netPlayer >= 1 && netPlayer <= 2 && colon > 0 && remotePort > 0)
+            mainWindow.startNetplay(static_cast<u8>(netPlayer - 1),
+                                    static_cast<u16>(netPort), host,
+                                    static_cast<u16>(remotePort),
+                                    static_cast<u32>(inputDelay));
+    }
+
+    /* Из командной строки запись всегда с включения консоли */
+    if (!playPath.isEmpty())
+        mainWindow.playMovie(playPath);
+    else if (!recordPath.isEmpty())
+        mainWindow.recordMovie(recordPath, Core::Movie::Start::POWER_ON);
+
     return app.exec();
 }
@@ -0,0 +1,291 @@
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/console.h"
+#include "core/rewind.h"
+
+#include "rom.h"
+
+/* Гарантии детерминизма, на которых держатся run-ahead, откат netplay,
+ * перемотка и сверка хэшей:
+ *   - одинаковый ввод даёт одинаковые хэши состояния на каждом кадре;
+ *   - кадр без вывода (skipOutput) и run-ahead не меняют ни состояния,
+ *     ни звука;
+ *   - снимок, загруженный в ту же или новую консоль, воспроизводит те же
+ *     кадры;
+ *   - перемотка назад (Core::Rewind) через границы ключевых снимков и
+ *     после вытеснения старых групп возвращает те же состояния.
+ * Код выхода ненулевой при первом расхождении каждой проверки.
+ */
+namespace {
+constexpr u64 FRAMES = 180;
+constexpr u64 SNAPSHOT_FRAME = 60;
+/* Маленькая группа, чтобы перемотка пересекала ключевые снимки */
+constexpr u32 REWIND_KEY_INTERVAL = 8;
+constexpr u64 REWIND_STEPS = 20;
+/* Около двух групп тестового ROM-а (ключевой снимок ~3 КБ, дельты
+ * ~0.6 КБ) */
+constexpr sz REWIND_SMALL_BUDGET = 16 * 1024;
+
+std::filesystem::path romPath;
+int failures = 0;
+
+void fail(const std::string &what, Core::PPU::Region region, u64 frame) {
+    std::fprintf(stderr, "FAIL %s (region %u, frame %llu)\n", what.c_str(),
+                 static_cast<unsigned>(region),
+                 static_cast<unsigned long long>(frame));
+    ++failures;
+}
+
+auto boot(Core::PPU::Region region) -> std::unique_ptr<Core::Console> {
+    auto console = std::make_unique<Core::Console>();
+    console->loadRom(romPath, NESPP_MAPPER_DIR);
+    console->setRegion(region);
+    return console;
+}
+
+void setInput(Core::Console &console, u64 frame) {
+    console.setJoy1(Test::joyInput(frame));
+    console.setJoy2(Test::joyInput(frame, 0x5A));
+}
+
+/* Звук кадра забирается, чтобы следующий кадр начинался с пустого */
+auto takeAudio(Core::Console &console) -> std::vector<f32> {
+    std::vector<f32> out;
+    out.swap(console.apu->samples);
+    return out;
+}
+
+/* Два прогона с одним вводом; stateHash() и saveSnapshot() сами
+ * состояния не меняют */
+void hashStability(Core::PPU::Region region) {
+    auto a = boot(region);
+    auto b = boot(region);
+    std::vector<u8> scratch;
+
+    for (u64 f = 0; f < FRAMES; ++f) {
+        setInput(*a, f);
+        setInput(*b, f);
+        if (!a->runFrame() || !b->runFrame()) {
+            fail("hash: runFrame", region, f);
+            return;
+        }
+
+        const Core::StateHash ha = a->stateHash();
+        if (a->stateHash() != ha) {
+            fail("hash: stateHash() changed the state", region, f);
+            return;
+        }
+        a->saveSnapshot(scratch);
+        if (a->stateHash() != ha) {
+            fail("hash: saveSnapshot() changed the state", region, f);
+            return;
+        }
+        if (b->stateHash() != ha) {
+            fail("hash: identical runs diverged", region, f);
+            return;
+        }
+    }
+}
+
+/* Кадры без вывода: то же состояние и тот же звук */
+void skipOutput(Core::PPU::Region region) {
+    auto shown = boot(region);
+    auto hidden = boot(region);
+
+    for (u64 f = 0; f < FRAMES; ++f) {
+        setInput(*shown, f);
+        setInput(*hidden, f);
+        const bool present = (f % 4) == 3;
+        if (!shown->runFrame() || !hidden->runFrame(present)) {
+            fail("skipOutput: runFrame", region, f);
+            return;
+        }
+
+        if (shown->stateHash() != hidden->stateHash()) {
+            fail("skipOutput: state diverged", region, f);
+            return;
+        }
+        if (takeAudio(*shown) != takeAudio(*hidden)) {
+            fail("skipOutput: audio diverged", region, f);
+            return;
+        }
+        if (present && shown->ppu->frame != hidden->ppu->frame) {
+            fail("skipOutput: presented frame differs", region, f);
+            return;
+        }
+    }
+}
+
+/* Run-ahead на 1-3 кадра: настоящее состояние и звук как у runFrame() */
+void runAhead(Core::PPU::Region region, u32 ahead) {
+    auto plain = boot(region);
+    auto spec = boot(region);
+
+    for (u64 f = 0; f < FRAMES; ++f) {
+        setInput(*plain, f);
+        setInput(*spec, f);
+        if (!plain->runFrame() || !spec->runFrameAhead(ahead)) {
+            fail("run-ahead: runFrame", region, f);
+            return;
+        }
+
+        if (plain->stateHash() != spec->stateHash()) {
+            fail("run-ahead " + std::to_string(ahead) + ": state diverged",
+                 region, f);
+            return;
+        }
+        if (takeAudio(*plain) != takeAudio(*spec)) {
+            fail("run-ahead " + std::to_string(ahead) + ": audio diverged",
+                 region, f);
+            return;
+        }
+    }
+}
+
+/* Снимок посреди прогона: повтор в той же консоли и в новой */
+void snapshotReplay(Core::PPU::Region region) {
+    auto a = boot(region);
+    std::vector<u8> snapshot;
+    std::vector<Core::StateHash> reference;
+
+    for (u64 f = 0; f < FRAMES; ++f) {
+        if (f == SNAPSHOT_FRAME)
+            a->saveSnapshot(snapshot);
+        setInput(*a, f);
+        if (!a->runFrame()) {
+            fail("replay: runFrame", region, f);
+            return;
+        }
+        if (f >= SNAPSHOT_FRAME)
+            reference.push_back(a->stateHash());
+    }
+
+    auto fresh = boot(region);
+    for (Core::Console *c : {a.get(), fresh.get()}) {
+        const char *who = (c == a.get()) ? "same console" : "new console";
+        c->loadSnapshot(snapshot);
+
+        std::vector<u8> again;
+        c->saveSnapshot(again);
+        if (again != snapshot) {
+            fail(std::string("replay: snapshot round trip, ") + who, region,
+                 SNAPSHOT_FRAME);
+            continue;
+        }
+
+        for (u64 f = SNAPSHOT_FRAME; f < FRAMES; ++f) {
+            setInput(*c, f);
+            if (!c->runFrame() ||
+                c->stateHash() != reference[f - SNAPSHOT_FRAME]) {
+                fail(std::string("replay: diverged, ") + who, region, f);
+                break;
+            }
+        }
+    }
+}
+
+/* Перемотка: снимок после каждого кадра, ключевой каждый восьмой.
+ * Возврат на REWIND_STEPS кадров и повтор с тем же вводом дают те же
+ * хэши. С маленьким бюджетом старые группы вытесняются, самая старая
+ * оставшаяся запись - ключевой снимок, и до неё тоже можно перемотать */
+void rewindReplay(Core::PPU::Region region) {
+    auto a = boot(region);
+    Core::Rewind ring(Core::Rewind::DEFAULT_BUDGET, 1, REWIND_KEY_INTERVAL);
+    Core::Rewind small(REWIND_SMALL_BUDGET, 1, REWIND_KEY_INTERVAL);
+    std::vector<Core::StateHash> reference;
+
+    for (u64 f = 0; f < FRAMES; ++f) {
+        setInput(*a, f);
+        if (!a->runFrame()) {
+            fail("rewind: runFrame", region, f);
+            return;
+        }
+        reference.push_back(a->stateHash());
+
+        ring.push(*a);
+        small.push(*a);
+    }
+
+    if (ring.size() != FRAMES) {
+        fail("rewind: snapshots were evicted", region, FRAMES);
+        return;
+    }
+
+    /* Запись k - состояние после кадра k */
+    const u64 target = FRAMES - REWIND_STEPS;
+    for (u64 f = FRAMES; f-- > target;) {
+        if (!ring.rewind(*a) || a->stateHash() != reference[f]) {
+            fail("rewind: wrong state", region, f);
+            return;
+        }
+    }
+
+    for (u64 f = target + 1; f < FRAMES; ++f) {
+        setInput(*a, f);
+        if (!a->runFrame() || a->stateHash() != reference[f]) {
+            fail("rewind: replay diverged", region, f);
+            return;
+        }
+    }
+
+    if (small.size() >= FRAMES || small.bytes() > small.getBudget()) {
+        fail("rewind: budget not enforced", region, FRAMES);
+        return;
+    }
+    const u64 oldest = FRAMES - small.size();
+    if (oldest % REWIND_KEY_INTERVAL != 0) {
+        fail("rewind: oldest entry is not a keyframe", region, oldest);
+        return;
+    }
+    for (u64 f = FRAMES; f-- > oldest;) {
+        if (!small.rewind(*a) || a->stateHash() != reference[f]) {
+            fail("rewind: wrong state after eviction", region, f);
+            return;
+        }
+    }
+    if (small.rewind(*a) || small.bytes() != 0)
+        fail("rewind: ring not empty", region, oldest);
+}
+} /* namespace */
+
+int main(int argc, char *argv[]) {
+    const std::string name = (argc > 1) ? argv[1] : "ntsc";
+    Core::PPU::Region region = Core::PPU::Region::NTSC;
+    if (name == "pal")
+        region = Core::PPU::Region::PAL;
+    else if (name == "dendy")
+        region = Core::PPU::Region::DENDY;
+    else if (name != "ntsc") {
+        std::fprintf(stderr, "Usage: %s [ntsc|pal|dendy]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        romPath = Test::writeRom("determinism-" + name);
+
+        hashStability(region);
+        skipOutput(region);
+        /* Глубина run-ahead от региона не зависит: все глубины на NTSC */
+        if (region == Core::PPU::Region::NTSC) {
+            for (u32 ahead = 1; ahead <= 3; ++ahead)
+                runAhead(region, ahead);
+        } else {
+            runAhead(region, 2);
+        }
+        snapshotReplay(region);
+        rewindReplay(region);
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (failures != 0)
+        return EXIT_FAILURE;
+
+    std::printf("determinism %s: ok\n", name.c_str());
+    return EXIT_SUCCESS;
+}
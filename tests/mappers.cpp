@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/console.h"
+
+#include "rom.h"
+
+/* Lua-мапперы (mappers/mpN.lua) против встроенных: один ROM с
+ * переключением банков, хэш состояния и кадр на каждом кадре должны
+ * совпадать. Снимки обеих консолей тоже совпадают байт в байт, и снимок
+ * встроенного маппера, загруженный в Lua (и наоборот), повторяет кадры.
+ * Код выхода ненулевой при первом расхождении каждого маппера.
+ */
+namespace {
+constexpr u64 FRAMES = 240;
+/* NMI этого кадра банки не переключает (ROM меняет их через кадр), так
+ * что банки из снимка сразу видны */
+constexpr u64 SNAPSHOT_FRAME = 91;
+constexpr u8 MAPPERS[] = {0, 1, 2, 3, 4, 7, 9};
+
+auto boot(const std::filesystem::path &romPath, bool lua)
+    -> std::unique_ptr<Core::Console> {
+    auto console = std::make_unique<Core::Console>();
+    console->luaMappers = lua;
+    console->loadRom(romPath, NESPP_MAPPER_DIR);
+    console->ppu->indexedOutput = true;
+    return console;
+}
+
+void setInput(Core::Console &console, u64 frame) {
+    console.setJoy1(Test::joyInput(frame));
+    console.setJoy2(Test::joyInput(frame, 0x5A));
+}
+
+/* Хэш маппера включает таблицу банков CHR, а mp9.lua её не публикует:
+ * CHR MMC2 считается по защёлкам при каждом чтении. Тогда вместо хэша
+ * маппера сравниваются его регистры, mirroring, IRQ и PRG-RAM */
+bool sameState(Core::Console &native, Core::Console &lua) {
+    const Core::StateHash a = native.stateHash();
+    const Core::StateHash b = lua.stateHash();
+    const Core::Mapper &n = *native.mapper;
+    const Core::Mapper &l = *lua.mapper;
+    if (n.chrBanked == l.chrBanked)
+        return a == b;
+
+    for (sz part = 0; part < Core::StateHash::COUNT; ++part) {
+        if (part != Core::StateHash::MAPPER && a.parts[part] != b.parts[part])
+            return false;
+    }
+    return native.mapper->registerBlob() == lua.mapper->registerBlob() &&
+           n.mirror == l.mirror && n.irqFlag == l.irqFlag &&
+           n.prgMap == l.prgMap && n.PRG_RAM == l.PRG_RAM;
+}
+
+bool fail(u8 mapper, const std::string &what, u64 frame) {
+    std::fprintf(stderr, "FAIL mapper %u: %s (frame %llu)\n",
+                 static_cast<unsigned>(mapper), what.c_str(),
+                 static_cast<unsigned long long>(frame));
+    return false;
+}
+
+bool compare(u8 mapper) {
+    Test::RomOptions options;
+    options.mapper = mapper;
+    const auto romPath =
+        Test::writeRom("mapper-" + std::to_string(mapper), options);
+
+    auto native = boot(romPath, false);
+    auto lua = boot(romPath, true);
+    if (!native->mapper->isNative() || lua->mapper->isNative())
+        return fail(mapper, "wrong mapper implementation", 0);
+
+    std::vector<u8> nativeSnapshot;
+    std::vector<u8> luaSnapshot;
+    std::vector<Core::StateHash> reference;
+
+    for (u64 f = 0; f < FRAMES; ++f) {
+        if (f == SNAPSHOT_FRAME) {
+            native->saveSnapshot(nativeSnapshot);
+            lua->saveSnapshot(luaSnapshot);
+            if (nativeSnapshot != luaSnapshot)
+                return fail(mapper, "snapshots differ", f);
+        }
+
+        setInput(*native, f);
+        setInput(*lua, f);
+        if (!native->runFrame() || !lua->runFrame())
+            return fail(mapper, "runFrame", f);
+
+        if (native->ppu->indexFrame != lua->ppu->indexFrame)
+            return fail(mapper, "frame differs", f);
+        if (!sameState(*native, *lua))
+            return fail(mapper, "state diverged", f);
+        if (f >= SNAPSHOT_FRAME)
+            reference.push_back(native->stateHash());
+    }
+
+    /* Снимок чужой реализации: регистры маппера в одном формате */
+    native->loadSnapshot(luaSnapshot);
+    lua->loadSnapshot(nativeSnapshot);
+    for (u64 f = SNAPSHOT_FRAME; f < FRAMES; ++f) {
+        setInput(*native, f);
+        setInput(*lua, f);
+        if (!native->runFrame() || !lua->runFrame())
+            return fail(mapper, "replay: runFrame", f);
+
+        if (native->stateHash() != reference[f - SNAPSHOT_FRAME])
+            return fail(mapper, "replay diverged, native", f);
+        if (!sameState(*native, *lua))
+            return fail(mapper, "replay diverged, lua", f);
+    }
+
+    return true;
+}
+} /* namespace */
+
+int main() {
+    int failures = 0;
+    try {
+        for (const u8 mapper : MAPPERS) {
+            if (!compare(mapper))
+                ++failures;
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (failures != 0)
+        return EXIT_FAILURE;
+
+    std::printf("mappers: ok\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/console.h"
+#include "core/movie.h"
+
+#include "rom.h"
+
+/* Запись ввода (Core::Movie) через файл: сохранение и загрузка дают ту же
+ * запись, серии одинакового ввода сжимаются, проигрывание повторяет хэши
+ * состояния записанного прогона. Запись со снимка проигрывается консолью
+ * другого региона (снимок переключает регион сам). Любой обрезанный файл
+ * отвергается. Код выхода ненулевой при первом расхождении каждой
+ * проверки.
+ */
+namespace {
+constexpr u64 FRAMES = 120;
+constexpr u64 WARMUP_FRAMES = 30;
+/* Ввод меняется раз в HOLD кадров: в файле одна серия на HOLD кадров */
+constexpr u64 HOLD = 8;
+constexpr sz HEADER_SIZE = 24;
+
+std::filesystem::path romPath;
+int failures = 0;
+
+void fail(const std::string &what, u64 frame) {
+    std::fprintf(stderr, "FAIL %s (frame %llu)\n", what.c_str(),
+                 static_cast<unsigned long long>(frame));
+    ++failures;
+}
+
+auto boot(Core::PPU::Region region) -> std::unique_ptr<Core::Console> {
+    auto console = std::make_unique<Core::Console>();
+    console->setRegion(region);
+    console->loadRom(romPath, NESPP_MAPPER_DIR);
+    console->ppu->indexedOutput = true;
+    return console;
+}
+
+auto moviePath(const std::string &name) -> std::filesystem::path {
+    return std::filesystem::temp_directory_path() /
+           ("nespp-movie-" + name + ".nmv");
+}
+
+auto readBytes(const std::filesystem::path &path) -> std::vector<u8> {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<u8>(std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>());
+}
+
+void writeBytes(const std::filesystem::path &path, const u8 *data, sz size) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data),
+               static_cast<std::streamsize>(size));
+}
+
+/* Запись FRAMES кадров с консоли в её текущем состоянии; хэши после
+ * каждого кадра - в reference */
+auto record(Core::Console &console, Core::Movie::Start start,
+            std::vector<Core::StateHash> &reference) -> Core::Movie {
+    Core::Movie movie;
+    movie.startRecording(console, start, Core::Movie::hashRom(romPath));
+
+    for (u64 f = 0; f < FRAMES; ++f) {
+        const u8 joy1 = Test::joyInput(f / HOLD);
+        const u8 joy2 = Test::joyInput(f / HOLD, 0x5A);
+        movie.record(joy1, joy2);
+        console.setJoy1(joy1);
+        console.setJoy2(joy2);
+        if (!console.runFrame()) {
+            fail("record: runFrame", f);
+            break;
+        }
+        reference.push_back(console.stateHash());
+    }
+    return movie;
+}
+
+void replay(Core::Movie &movie, Core::Console &console,
+            const std::vector<Core::StateHash> &reference,
+            const std::string &name) {
+    movie.startPlayback(console);
+    if (console.getRegion() != movie.getRegion()) {
+        fail(name + ": region not restored", 0);
+        return;
+    }
+
+    u8 joy1 = 0;
+    u8 joy2 = 0;
+    for (u64 f = 0; f < reference.size(); ++f) {
+        if (!movie.next(joy1, joy2)) {
+            fail(name + ": movie ended early", f);
+            return;
+        }
+        console.setJoy1(joy1);
+        console.setJoy2(joy2);
+        if (!console.runFrame() || console.stateHash() != reference[f]) {
+            fail(name + ": playback diverged", f);
+            return;
+        }
+    }
+
+    if (movie.next(joy1, joy2) || !movie.finished())
+        fail(name + ": movie longer than recorded", reference.size());
+}
+
+/* Сохранение, загрузка, проигрывание, затем все обрезки файла */
+void roundTrip(const std::string &name, Core::Movie &recorded,
+               sz snapshotSize, Core::PPU::Region playbackRegion,
+               const std::vector<Core::StateHash> &reference) {
+    const auto path = moviePath(name);
+    recorded.save(path);
+
+    Core::Movie loaded;
+    loaded.load(path);
+    if (loaded.frames() != recorded.frames() ||
+        loaded.getStart() != recorded.getStart() ||
+        loaded.getRegion() != recorded.getRegion() ||
+        loaded.getRomHash() != recorded.getRomHash()) {
+        fail(name + ": header changed", 0);
+        return;
+    }
+
+    /* Заголовок, снимок и серии: байт длины и два байта ввода на HOLD
+     * кадров вместо 2 * HOLD байт */
+    const std::vector<u8> file = readBytes(path);
+    const sz runs = (FRAMES + HOLD - 1) / HOLD;
+    if (file.size() != HEADER_SIZE + snapshotSize + runs * 3)
+        fail(name + ": inputs not run-length encoded", FRAMES);
+
+    auto console = (recorded.getStart() == Core::Movie::Start::POWER_ON)
+                       ? boot(recorded.getRegion())
+                       : boot(playbackRegion);
+    replay(loaded, *console, reference, name);
+
+    const auto cut = moviePath(name + "-cut");
+    for (sz size = 0; size < file.size(); ++size) {
+        writeBytes(cut, file.data(), size);
+        Core::Movie truncated;
+        try {
+            truncated.load(cut);
+        } catch (const std::runtime_error &) {
+            continue;
+        }
+        fail(name + ": truncated file accepted, " + std::to_string(size) +
+                 " of " + std::to_string(file.size()) + " bytes",
+             0);
+        break;
+    }
+
+    std::filesystem::remove(cut);
+    std::filesystem::remove(path);
+}
+} /* namespace */
+
+int main() {
+    try {
+        romPath = Test::writeRom("movie");
+
+        /* С включения, NTSC */
+        {
+            std::vector<Core::StateHash> reference;
+            auto console = boot(Core::PPU::Region::NTSC);
+            Core::Movie movie = record(*console,
+                                       Core::Movie::Start::POWER_ON,
+                                       reference);
+            roundTrip("power-on", movie, 0, Core::PPU::Region::NTSC,
+                      reference);
+        }
+
+        /* Со снимка посреди игры на PAL, проигрывает консоль NTSC */
+        {
+            std::vector<Core::StateHash> reference;
+            auto console = boot(Core::PPU::Region::PAL);
+            for (u64 f = 0; f < WARMUP_FRAMES; ++f) {
+                console->setJoy1(Test::joyInput(f, 0x33));
+                if (!console->runFrame())
+                    fail("warmup: runFrame", f);
+            }
+            std::vector<u8> snapshot;
+            console->saveSnapshot(snapshot);
+            Core::Movie movie = record(*console,
+                                       Core::Movie::Start::SNAPSHOT,
+                                       reference);
+            roundTrip("snapshot", movie, snapshot.size(),
+                      Core::PPU::Region::NTSC, reference);
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (failures != 0)
+        return EXIT_FAILURE;
+
+    std::printf("movie: ok\n");
+    return EXIT_SUCCESS;
+}
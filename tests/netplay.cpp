@@ -0,0 +1,200 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/console.h"
+#include "core/netplay.h"
+#include "core/transport.h"
+
+#include "rom.h"
+
+/* Две сессии Netplay в одном процессе через LoopbackTransport с задержкой
+ * и потерями: откаты должны случаться, а окончательные кадры у обеих
+ * сторон совпадать с консолью, которой сразу дали настоящий ввод обоих
+ * игроков. Отдельно UdpTransport на 127.0.0.1 пропускает датаграммы
+ * только от своего собеседника. Код выхода ненулевой при первом
+ * расхождении каждой проверки.
+ */
+namespace {
+/* Кадры с меняющимся вводом, затем ввод держится: предсказание (последний
+ * известный чужой ввод) становится верным, откатов больше нет и кадры
+ * окончательные сразу после эмуляции */
+constexpr u64 ACTIVE_FRAMES = 240;
+constexpr u64 HELD_FRAMES = 60;
+constexpr u64 FRAMES = ACTIVE_FRAMES + HELD_FRAMES;
+constexpr u64 SETTLE_FRAMES = 40;
+
+constexpr u32 INPUT_DELAY = 1;
+
+constexpr u16 UDP_PORT = 47310;
+
+std::filesystem::path romPath;
+int failures = 0;
+
+void fail(const std::string &what, u64 frame) {
+    std::fprintf(stderr, "FAIL %s (frame %llu)\n", what.c_str(),
+                 static_cast<unsigned long long>(frame));
+    ++failures;
+}
+
+auto boot() -> std::unique_ptr<Core::Console> {
+    auto console = std::make_unique<Core::Console>();
+    console->loadRom(romPath, NESPP_MAPPER_DIR);
+    console->ppu->indexedOutput = true;
+    return console;
+}
+
+/* Ввод, который игрок отдаёт advance() на своём кадре frame */
+auto playerInput(u8 player, u64 frame) -> u8 {
+    if (frame >= ACTIVE_FRAMES)
+        return 0;
+    return (player == 0) ? Test::joyInput(frame)
+                         : Test::joyInput(frame, 0x5A);
+}
+
+/* На кадре frame действует ввод, отданный INPUT_DELAY кадров назад */
+auto padInput(u8 player, u64 frame) -> u8 {
+    return (frame < INPUT_DELAY) ? 0
+                                 : playerInput(player, frame - INPUT_DELAY);
+}
+
+struct Side {
+    std::unique_ptr<Core::Console> console;
+    std::unique_ptr<Core::Netplay> session;
+    u8 player{0};
+    /* Хэш после кадра f, когда он впервые показан */
+    std::map<u64, Core::StateHash> hashes;
+};
+
+bool step(Side &side) {
+    const u64 frame = side.session->frame();
+    if (!side.session->advance(playerInput(side.player, frame)))
+        return false;
+    if (side.session->frame() != frame)
+        side.hashes.emplace(frame, side.console->stateHash());
+    return true;
+}
+
+void loopback(u32 latency, u32 lossPercent) {
+    const std::string name = "loopback latency " + std::to_string(latency) +
+                             ", loss " + std::to_string(lossPercent) + "%";
+
+    auto [ta, tb] = Core::LoopbackTransport::makePair(latency, lossPercent);
+    Side sides[2];
+    for (u8 p = 0; p < 2; ++p) {
+        Core::Netplay::Config config;
+        config.localPlayer = p;
+        config.inputDelay = INPUT_DELAY;
+        sides[p].player = p;
+        sides[p].console = boot();
+        sides[p].session = std::make_unique<Core::Netplay>(
+            *sides[p].console, (p == 0) ? *ta : *tb, config);
+    }
+
+    /* Обе стороны по очереди, пока обе не пройдут FRAMES кадров: та, что
+     * впереди, ждёт собеседника внутри advance() */
+    for (u64 calls = 0; sides[0].session->frame() < FRAMES ||
+                        sides[1].session->frame() < FRAMES;
+         ++calls) {
+        if (calls > FRAMES * 4) {
+            fail(name + ": sessions stalled", sides[0].session->frame());
+            return;
+        }
+        for (Side &side : sides) {
+            if (!step(side)) {
+                fail(name + ": runFrame", side.session->frame());
+                return;
+            }
+        }
+    }
+
+    for (const Side &side : sides) {
+        const auto &stats = side.session->getStats();
+        if (side.session->desynced())
+            fail(name + ": desynced", side.session->desyncFrame());
+        if (stats.rollbacks == 0)
+            fail(name + ": no rollbacks", FRAMES);
+    }
+
+    /* Окончательные кадры против консоли с настоящим вводом обоих */
+    auto reference = boot();
+    for (u64 f = 0; f < FRAMES; ++f) {
+        reference->setJoy1(padInput(0, f));
+        reference->setJoy2(padInput(1, f));
+        if (!reference->runFrame()) {
+            fail(name + ": reference runFrame", f);
+            return;
+        }
+        if (f < ACTIVE_FRAMES + SETTLE_FRAMES)
+            continue;
+
+        const Core::StateHash expected = reference->stateHash();
+        for (const Side &side : sides) {
+            const auto it = side.hashes.find(f);
+            if (it == side.hashes.end() || it->second != expected) {
+                fail(name + ": player " + std::to_string(side.player) +
+                         " diverged",
+                     f);
+                return;
+            }
+        }
+    }
+}
+
+/* Чужой сокет шлёт на тот же порт: такие датаграммы не доходят */
+void udpSender() {
+    std::unique_ptr<Core::UdpTransport> a;
+    std::unique_ptr<Core::UdpTransport> b;
+    std::unique_ptr<Core::UdpTransport> stranger;
+    try {
+        a = std::make_unique<Core::UdpTransport>(UDP_PORT, "127.0.0.1",
+                                                 UDP_PORT + 1);
+        b = std::make_unique<Core::UdpTransport>(UDP_PORT + 1, "127.0.0.1",
+                                                 UDP_PORT);
+        stranger = std::make_unique<Core::UdpTransport>(
+            UDP_PORT + 2, "127.0.0.1", UDP_PORT + 1);
+    } catch (const std::runtime_error &e) {
+        std::printf("udp: skipped (%s)\n", e.what());
+        return;
+    }
+
+    const u8 foreign[] = {'X'};
+    const u8 expected[] = {'N', 'P'};
+    stranger->send(foreign, sizeof(foreign));
+    a->send(expected, sizeof(expected));
+
+    std::vector<u8> got;
+    for (int i = 0; i < 200 && !b->receive(got); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    if (got != std::vector<u8>(expected, expected + sizeof(expected)))
+        fail("udp: datagram from another address accepted", 0);
+    else if (b->receive(got))
+        fail("udp: unexpected extra datagram", 0);
+}
+} /* namespace */
+
+int main() {
+    try {
+        romPath = Test::writeRom("netplay");
+
+        loopback(2, 0);
+        loopback(3, 20);
+        udpSender();
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (failures != 0)
+        return EXIT_FAILURE;
+
+    std::printf("netplay: ok\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "core/console.h"
+
+#include "rom.h"
+
+/* Построчная отрисовка (PPU::scanlineRenderer) против отрисовки по
+ * точкам: индексы кадра и хэш состояния должны совпадать на каждом кадре.
+ * ROM-ы покрывают спрайты 8x8 и 8x16, смену PPUMASK посреди кадра, их
+ * сочетание и MMC3 (тик счётчика строк и IRQ посреди кадра). Код выхода
+ * ненулевой при первом расхождении каждого ROM-а.
+ */
+namespace {
+constexpr u64 FRAMES = 300;
+
+struct Variant {
+    const char *name;
+    Test::RomOptions options;
+};
+
+auto boot(const std::filesystem::path &romPath, bool scanline)
+    -> std::unique_ptr<Core::Console> {
+    auto console = std::make_unique<Core::Console>();
+    console->loadRom(romPath, NESPP_MAPPER_DIR);
+    console->ppu->scanlineRenderer = scanline;
+    console->ppu->indexedOutput = true;
+    return console;
+}
+
+bool compare(const Variant &variant) {
+    const auto romPath =
+        Test::writeRom(std::string("renderer-") + variant.name,
+                       variant.options);
+    auto fast = boot(romPath, true);
+    auto dots = boot(romPath, false);
+
+    for (u64 f = 0; f < FRAMES; ++f) {
+        for (Core::Console *c : {fast.get(), dots.get()}) {
+            c->setJoy1(Test::joyInput(f));
+            c->setJoy2(Test::joyInput(f, 0x5A));
+        }
+        if (!fast->runFrame() || !dots->runFrame()) {
+            std::fprintf(stderr, "FAIL %s: runFrame (frame %llu)\n",
+                         variant.name, static_cast<unsigned long long>(f));
+            return false;
+        }
+
+        const char *what = nullptr;
+        if (fast->ppu->indexFrame != dots->ppu->indexFrame)
+            what = "frame differs";
+        else if (fast->stateHash() != dots->stateHash())
+            what = "state diverged";
+        if (what) {
+            std::fprintf(stderr, "FAIL %s: %s (frame %llu)\n", variant.name,
+                         what, static_cast<unsigned long long>(f));
+            return false;
+        }
+    }
+
+    return true;
+}
+} /* namespace */
+
+int main() {
+    const Variant variants[] = {
+        {"default", {}},
+        {"tall", {true, false}},
+        {"mask", {false, true}},
+        {"tall-mask", {true, true}},
+        {"mmc3", {false, false, 4}},
+        {"mmc3-tall-mask", {true, true, 4}},
+    };
+
+    int failures = 0;
+    try {
+        for (const Variant &variant : variants) {
+            if (!compare(variant))
+                ++failures;
+        }
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (failures != 0)
+        return EXIT_FAILURE;
+
+    std::printf("renderer: ok\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,633 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/types.h"
+
+/* Синтетический ROM для тестов: собирается на лету, так что тестам не
+ * нужны файлы игр. Программа ждёт sprite-0 hit, меняет scroll посреди
+ * кадра, в NMI читает оба джойстика, двигает спрайты (OAM DMA), мигает
+ * палитрой и пишет в APU - нагружено всё, что хэшируется. Для мапперов
+ * 1, 2, 3, 4, 7 и 9 NMI ещё и переключает банки PRG/CHR, а MMC3 считает
+ * строки и в IRQ меняет банк CHR посреди кадра.
+ */
+namespace Test {
+
+/* Опкоды 6502, суффикс - режим адресации */
+enum Op : u8 {
+    ADC_ABS = 0x6D,
+    ADC_IMM = 0x69,
+    ADC_ZP = 0x65,
+    AND_IMM = 0x29,
+    ASL = 0x0A,
+    BEQ = 0xF0,
+    BIT_ABS = 0x2C,
+    BNE = 0xD0,
+    BPL = 0x10,
+    BVC = 0x50,
+    BVS = 0x70,
+    CLC = 0x18,
+    CLI = 0x58,
+    CLD = 0xD8,
+    CPX_IMM = 0xE0,
+    CPY_IMM = 0xC0,
+    DEX = 0xCA,
+    EOR_ZP = 0x45,
+    INC_ABSX = 0xFE,
+    INC_ZP = 0xE6,
+    INX = 0xE8,
+    INY = 0xC8,
+    JMP_ABS = 0x4C,
+    LDA_ABS = 0xAD,
+    LDA_ABSX = 0xBD,
+    LDA_IMM = 0xA9,
+    LDA_ZP = 0xA5,
+    LDX_IMM = 0xA2,
+    LDY_IMM = 0xA0,
+    LSR = 0x4A,
+    ORA_IMM = 0x09,
+    ORA_ZP = 0x05,
+    PHA = 0x48,
+    PLA = 0x68,
+    ROL_ZP = 0x26,
+    RTI = 0x40,
+    SEI = 0x78,
+    STA_ABS = 0x8D,
+    STA_ABSX = 0x9D,
+    STA_ZP = 0x85,
+    TAX = 0xAA,
+    TXA = 0x8A,
+    TXS = 0x9A,
+    TYA = 0x98,
+};
+
+/* Ассемблер в одну сторону: метки разрешаются в finish() */
+class Asm {
+public:
+    explicit Asm(u16 org) : org(org) {}
+
+    u16 pc() const { return static_cast<u16>(org + code.size()); }
+    void label(const std::string &name) { labels[name] = pc(); }
+
+    void op(Op o) { code.push_back(o); }
+    void imm(Op o, u8 value) {
+        code.push_back(o);
+        code.push_back(value);
+    }
+    void abs(Op o, u16 addr) {
+        code.push_back(o);
+        code.push_back(static_cast<u8>(addr & 0xFF));
+        code.push_back(static_cast<u8>(addr >> 8));
+    }
+    void abs(Op o, const std::string &target) {
+        code.push_back(o);
+        absFix.emplace_back(code.size(), target);
+        code.insert(code.end(), 2, 0);
+    }
+    void rel(Op o, const std::string &target) {
+        code.push_back(o);
+        relFix.emplace_back(code.size(), target);
+        code.push_back(0);
+    }
+    void bytes(std::initializer_list<u8> data) {
+        code.insert(code.end(), data);
+    }
+
+    auto finish() -> const std::vector<u8> & {
+        for (const auto &[pos, target] : absFix) {
+            const u16 addr = at(target);
+            code[pos] = static_cast<u8>(addr & 0xFF);
+            code[pos + 1] = static_cast<u8>(addr >> 8);
+        }
+        for (const auto &[pos, target] : relFix) {
+            const i32 next = org + static_cast<i32>(pos) + 1;
+            const i32 offset = static_cast<i32>(at(target)) - next;
+            if (offset < -128 || offset > 127)
+                throw std::runtime_error("[TEST]: Далёкий переход на " +
+                                         target);
+            code[pos] = static_cast<u8>(offset & 0xFF);
+        }
+        return code;
+    }
+
+    u16 at(const std::string &name) const {
+        const auto it = labels.find(name);
+        if (it == labels.end())
+            throw std::runtime_error("[TEST]: Нет метки " + name);
+        return it->second;
+    }
+
+private:
+    u16 org;
+    std::vector<u8> code;
+    std::map<std::string, u16> labels;
+    std::vector<std::pair<sz, std::string>> absFix;
+    std::vector<std::pair<sz, std::string>> relFix;
+};
+
+struct RomOptions {
+    bool tallSprites{false}; /* спрайты 8x16 (PPUCTRL бит 5) */
+    bool maskCycle{false};   /* PPUMASK: emphasis, greyscale и левый край */
+    u8 mapper{0};            /* 0, 1, 2, 3, 4, 7 или 9 */
+};
+
+/* Размеры PRG и CHR (0 - CHR-RAM) для маппера */
+struct RomLayout {
+    sz prgSize;
+    sz chrSize;
+};
+
+inline auto romLayout(u8 mapper) -> RomLayout {
+    switch (mapper) {
+    case 0:
+        return {0x8000, 0x2000};
+    case 1:
+    case 4:
+    case 9:
+        return {0x20000, 0x8000};
+    case 2:
+    case 7:
+        return {0x20000, 0};
+    case 3:
+        return {0x8000, 0x8000};
+    default:
+        throw std::runtime_error("[TEST]: Нет тестового ROM для маппера " +
+                                 std::to_string(mapper));
+    }
+}
+
+/* MMC1: пять последовательных записей младшего бита A в регистр reg */
+inline void mmc1Write(Asm &a, u16 reg) {
+    for (int bit = 0; bit < 5; ++bit) {
+        if (bit != 0)
+            a.op(LSR);
+        a.abs(STA_ABS, reg);
+    }
+}
+
+/* Образ .nes целиком: заголовок, PRG и CHR по romLayout(). Программа
+ * идёт с $E000 и лежит в начале каждого банка PRG по 8 КБ, так что при
+ * любом переключении банков она на месте; в остальном банки различаются
+ * данными с $1000 */
+inline auto buildRom(const RomOptions &opt = {}) -> std::vector<u8> {
+    const u8 ctrl = static_cast<u8>(0x90 | (opt.tallSprites ? 0x20 : 0x00));
+    const RomLayout layout = romLayout(opt.mapper);
+
+    Asm a(0xE000);
+
+    a.label("reset");
+    a.op(SEI);
+    a.op(CLD);
+    a.imm(LDX_IMM, 0xFF);
+    a.op(TXS);
+    a.imm(LDA_IMM, 0x00);
+    a.abs(STA_ABS, 0x2000);
+    a.abs(STA_ABS, 0x2001);
+
+    /* Маппер: режимы и mirroring */
+    switch (opt.mapper) {
+    case 1:
+        /* Сброс сдвигового регистра; PRG $C000 фиксирован, CHR по 4 КБ,
+         * vertical */
+        a.imm(LDA_IMM, 0x80);
+        a.abs(STA_ABS, 0x8000);
+        a.imm(LDA_IMM, 0x1E);
+        mmc1Write(a, 0x8000);
+        break;
+    case 4:
+        a.imm(LDA_IMM, 0x00);
+        a.abs(STA_ABS, 0xA000);
+        break;
+    case 7:
+        a.imm(LDA_IMM, 0x00);
+        a.abs(STA_ABS, 0x8000);
+        break;
+    case 9:
+        a.imm(LDA_IMM, 0x00);
+        a.abs(STA_ABS, 0xF000);
+        break;
+    default:
+        break;
+    }
+
+    for (const char *wait : {"vblank1", "vblank2"}) {
+        a.label(wait);
+        a.abs(BIT_ABS, 0x2002);
+        a.rel(BPL, wait);
+    }
+
+    /* CHR-RAM: узор из 32 страниц, тайл 1 обеих таблиц сплошной */
+    if (layout.chrSize == 0) {
+        a.imm(LDA_IMM, 0x00);
+        a.abs(STA_ABS, 0x2006);
+        a.abs(STA_ABS, 0x2006);
+        a.imm(STA_ZP, 0x17);
+        a.imm(LDX_IMM, 32);
+        a.label("chrPage");
+        a.imm(LDY_IMM, 0);
+        a.label("chrByte");
+        a.op(TYA);
+        a.imm(EOR_ZP, 0x17);
+        a.abs(STA_ABS, 0x2007);
+        a.op(INY);
+        a.rel(BNE, "chrByte");
+        a.imm(LDA_ZP, 0x17);
+        a.op(CLC);
+        a.imm(ADC_IMM, 0x35);
+        a.imm(STA_ZP, 0x17);
+        a.op(DEX);
+        a.rel(BNE, "chrPage");
+
+        for (const u8 table : {u8{0x00}, u8{0x10}}) {
+            const std::string loop = "chrSolid" + std::to_string(table);
+            a.imm(LDA_IMM, table);
+            a.abs(STA_ABS, 0x2006);
+            a.imm(LDA_IMM, 0x10);
+            a.abs(STA_ABS, 0x2006);
+            a.imm(LDA_IMM, 0xFF);
+            a.imm(LDX_IMM, 16);
+            a.label(loop);
+            a.abs(STA_ABS, 0x2007);
+            a.op(DEX);
+            a.rel(BNE, loop);
+        }
+    }
+
+    /* Палитра $3F00-$3F1F */
+    a.imm(LDA_IMM, 0x3F);
+    a.abs(STA_ABS, 0x2006);
+    a.imm(LDA_IMM, 0x00);
+    a.abs(STA_ABS, 0x2006);
+    a.imm(LDX_IMM, 0x00);
+    a.label("palette");
+    a.abs(LDA_ABSX, "paletteData");
+    a.abs(STA_ABS, 0x2007);
+    a.op(INX);
+    a.imm(CPX_IMM, 32);
+    a.rel(BNE, "palette");
+
+    /* Nametable-ы $2000-$27FF: 2 КБ меняющихся тайлов и атрибутов */
+    a.imm(LDA_IMM, 0x20);
+    a.abs(STA_ABS, 0x2006);
+    a.imm(LDA_IMM, 0x00);
+    a.abs(STA_ABS, 0x2006);
+    a.imm(LDX_IMM, 8);
+    a.imm(LDY_IMM, 0);
+    a.label("nametable");
+    a.op(TYA);
+    a.imm(ADC_ZP, 0x20);
+    a.abs(STA_ABS, 0x2007);
+    a.op(INY);
+    a.rel(BNE, "nametable");
+    a.imm(INC_ZP, 0x20);
+    a.op(DEX);
+    a.rel(BNE, "nametable");
+
+    /* OAM в $0200: 64 спрайта лесенкой, все флаги атрибутов */
+    a.imm(LDX_IMM, 0);
+    a.imm(LDY_IMM, 0);
+    a.label("oam");
+    a.op(TYA);
+    a.op(ASL);
+    a.imm(ADC_ZP, 0x21);
+    a.abs(STA_ABSX, 0x0200);
+    a.op(INX);
+    a.op(TYA);
+    a.abs(STA_ABSX, 0x0200);
+    a.op(INX);
+    a.op(TYA);
+    a.imm(AND_IMM, 0xE3);
+    a.abs(STA_ABSX, 0x0200);
+    a.op(INX);
+    a.op(TYA);
+    a.op(ASL);
+    a.op(ASL);
+    a.abs(STA_ABSX, 0x0200);
+    a.op(INX);
+    a.op(INY);
+    a.imm(CPY_IMM, 64);
+    a.rel(BNE, "oam");
+
+    /* Спрайт 0: y = 100, x = 120, сплошной тайл 1 */
+    a.imm(LDA_IMM, 100);
+    a.abs(STA_ABS, 0x0200);
+    a.imm(LDA_IMM, 1);
+    a.abs(STA_ABS, 0x0201);
+    a.imm(LDA_IMM, 0);
+    a.abs(STA_ABS, 0x0202);
+    a.imm(LDA_IMM, 120);
+    a.abs(STA_ABS, 0x0203);
+
+    /* APU: два канала и шум */
+    const std::array<std::pair<u16, u8>, 12> apuInit = {{
+        {0x4015, 0x0F},
+        {0x4017, 0x40},
+        {0x4000, 0x9F},
+        {0x4002, 0x80},
+        {0x4003, 0x01},
+        {0x4008, 0x81},
+        {0x400A, 0x40},
+        {0x400B, 0x02},
+        {0x400C, 0x3F},
+        {0x400E, 0x05},
+        {0x400F, 0x10},
+        {0x2001, 0x1E},
+    }};
+    for (const auto &[reg, value] : apuInit) {
+        a.imm(LDA_IMM, value);
+        a.abs(STA_ABS, reg);
+    }
+    a.imm(LDA_IMM, ctrl);
+    a.abs(STA_ABS, 0x2000);
+
+    /* MMC3: IRQ на строке из $C000 */
+    if (opt.mapper == 4) {
+        a.imm(LDA_IMM, 0x40);
+        a.abs(STA_ABS, 0xC000);
+        a.abs(STA_ABS, 0xC001);
+        a.abs(STA_ABS, 0xE001);
+        a.op(CLI);
+    }
+
+    /* Главный цикл: дождаться sprite-0 hit и сменить scroll и PPUMASK
+     * посреди кадра. Потом NMI ждём по флагу $14 в RAM: до vblank CPU не
+     * трогает PPU, и низ экрана рисуется построчно (scanlineRenderer) */
+    a.label("main");
+    a.label("vblank");
+    a.imm(LDA_ZP, 0x14);
+    a.rel(BEQ, "vblank");
+    a.imm(LDA_IMM, 0);
+    a.imm(STA_ZP, 0x14);
+    a.label("hitClear");
+    a.abs(BIT_ABS, 0x2002);
+    a.rel(BVS, "hitClear");
+    a.label("hitSet");
+    a.abs(BIT_ABS, 0x2002);
+    a.rel(BVC, "hitSet");
+    a.imm(LDA_ZP, 0x11);
+    a.op(ASL);
+    a.abs(STA_ABS, 0x2005);
+    a.imm(LDA_IMM, 0);
+    a.abs(STA_ABS, 0x2005);
+    a.imm(LDX_IMM, 30);
+    a.label("delay");
+    a.op(DEX);
+    a.rel(BNE, "delay");
+    a.imm(LDA_ZP, 0x11);
+    if (opt.maskCycle) {
+        /* Emphasis, greyscale и левые 8 пикселей от счётчика кадров */
+        a.imm(AND_IMM, 0xE7);
+        a.imm(ORA_IMM, 0x18);
+    } else {
+        a.imm(AND_IMM, 0x01);
+        a.imm(ORA_IMM, 0x1E);
+    }
+    a.abs(STA_ABS, 0x2001);
+    a.abs(JMP_ABS, "main");
+
+    a.label("nmi");
+    a.op(PHA);
+    a.op(TXA);
+    a.op(PHA);
+    a.imm(LDA_IMM, 0);
+    a.abs(STA_ABS, 0x2003);
+    a.imm(LDA_IMM, 2);
+    a.abs(STA_ABS, 0x4014);
+    a.imm(INC_ZP, 0x11);
+    a.imm(INC_ZP, 0x14);
+
+    /* Джойстики: $12 и $13, сумма подмешивается в счётчик $11 */
+    a.imm(LDA_IMM, 1);
+    a.abs(STA_ABS, 0x4016);
+    a.imm(LDA_IMM, 0);
+    a.abs(STA_ABS, 0x4016);
+    a.imm(LDX_IMM, 8);
+    a.label("joy");
+    a.abs(LDA_ABS, 0x4016);
+    a.op(LSR);
+    a.imm(ROL_ZP, 0x12);
+    a.abs(LDA_ABS, 0x4017);
+    a.op(LSR);
+    a.imm(ROL_ZP, 0x13);
+    a.op(DEX);
+    a.rel(BNE, "joy");
+    a.imm(LDA_ZP, 0x12);
+    a.op(CLC);
+    a.imm(ADC_ZP, 0x13);
+    a.op(CLC);
+    a.imm(ADC_ZP, 0x11);
+    a.imm(STA_ZP, 0x11);
+
+    /* Scroll, nametable и таблица паттернов от счётчика */
+    a.imm(LDA_ZP, 0x11);
+    a.abs(STA_ABS, 0x2005);
+    a.imm(LDA_ZP, 0x11);
+    a.op(LSR);
+    a.abs(STA_ABS, 0x2005);
+    a.imm(LDA_ZP, 0x11);
+    a.imm(AND_IMM, 0x01);
+    a.imm(ORA_IMM, ctrl);
+    a.abs(STA_ABS, 0x2000);
+
+    /* Мигание цвета $3F01 */
+    a.imm(LDA_IMM, 0x3F);
+    a.abs(STA_ABS, 0x2006);
+    a.imm(LDA_IMM, 0x01);
+    a.abs(STA_ABS, 0x2006);
+    a.imm(LDA_ZP, 0x11);
+    a.imm(AND_IMM, 0x3F);
+    a.abs(STA_ABS, 0x2007);
+    a.imm(LDA_IMM, 0);
+    a.abs(STA_ABS, 0x2006);
+    a.abs(STA_ABS, 0x2006);
+
+    /* Все спрайты кроме нулевого едут вправо */
+    a.imm(LDX_IMM, 4);
+    a.label("move");
+    a.abs(INC_ABSX, 0x0203);
+    a.op(INX);
+    a.op(INX);
+    a.op(INX);
+    a.op(INX);
+    a.rel(BNE, "move");
+    a.imm(LDA_ZP, 0x11);
+    a.abs(STA_ABS, 0x4002);
+    a.abs(LDA_ABS, 0x4015);
+
+    /* Данные переключаемых окон PRG в $15, потом банки от счётчика $11
+     * через кадр: банки переживают границу кадра, и их видно в снимке */
+    if (opt.mapper != 0) {
+        a.abs(LDA_ABS, 0x9000);
+        a.op(CLC);
+        a.abs(ADC_ABS, 0xB000);
+        a.abs(ADC_ABS, 0xD000);
+        a.imm(STA_ZP, 0x15);
+        a.imm(INC_ZP, 0x18);
+        a.imm(LDA_ZP, 0x18);
+        a.imm(AND_IMM, 0x01);
+        a.rel(BNE, "nmiDone");
+    }
+
+    switch (opt.mapper) {
+    case 1:
+        a.imm(LDA_ZP, 0x11);
+        mmc1Write(a, 0xE000);
+        a.imm(LDA_ZP, 0x11);
+        mmc1Write(a, 0xA000);
+        a.imm(LDA_ZP, 0x11);
+        a.op(LSR);
+        mmc1Write(a, 0xC000);
+        break;
+    case 2:
+    case 3:
+        a.imm(LDA_ZP, 0x11);
+        a.abs(STA_ABS, 0x8000);
+        break;
+    case 4:
+        /* R0-R7, режимы PRG/CHR и строка IRQ */
+        a.imm(LDX_IMM, 7);
+        a.label("mmc3Bank");
+        a.imm(LDA_ZP, 0x11);
+        a.imm(AND_IMM, 0xC0);
+        a.imm(STA_ZP, 0x17);
+        a.op(TXA);
+        a.imm(ORA_ZP, 0x17);
+        a.abs(STA_ABS, 0x8000);
+        a.op(TXA);
+        a.op(CLC);
+        a.imm(ADC_ZP, 0x11);
+        a.abs(STA_ABS, 0x8001);
+        a.op(DEX);
+        a.rel(BPL, "mmc3Bank");
+        a.imm(LDA_ZP, 0x11);
+        a.imm(AND_IMM, 0x3F);
+        a.imm(ORA_IMM, 0x10);
+        a.abs(STA_ABS, 0xC000);
+        a.abs(STA_ABS, 0xC001);
+        a.abs(STA_ABS, 0xE001);
+        break;
+    case 7:
+        a.imm(LDA_ZP, 0x11);
+        a.imm(AND_IMM, 0x17);
+        a.abs(STA_ABS, 0x8000);
+        break;
+    case 9:
+        a.imm(LDA_ZP, 0x11);
+        a.abs(STA_ABS, 0xA000);
+        a.abs(STA_ABS, 0xB000);
+        a.op(LSR);
+        a.abs(STA_ABS, 0xC000);
+        a.op(LSR);
+        a.abs(STA_ABS, 0xD000);
+        a.op(LSR);
+        a.abs(STA_ABS, 0xE000);
+        break;
+    default:
+        break;
+    }
+
+    a.label("nmiDone");
+    a.op(PLA);
+    a.op(TAX);
+    a.op(PLA);
+    a.op(RTI);
+
+    /* MMC3: подтвердить IRQ и сменить банк R2 посреди кадра */
+    a.label("irq");
+    if (opt.mapper == 4) {
+        a.op(PHA);
+        a.abs(STA_ABS, 0xE000);
+        a.abs(STA_ABS, 0xE001);
+        a.imm(INC_ZP, 0x16);
+        a.imm(LDA_IMM, 0x02);
+        a.abs(STA_ABS, 0x8000);
+        a.imm(LDA_ZP, 0x16);
+        a.abs(STA_ABS, 0x8001);
+        a.op(PLA);
+    }
+    a.op(RTI);
+
+    a.label("paletteData");
+    a.bytes({0x0F, 0x01, 0x11, 0x21, 0x0F, 0x06, 0x16, 0x26,
+             0x0F, 0x09, 0x19, 0x29, 0x0F, 0x02, 0x12, 0x22,
+             0x0F, 0x14, 0x24, 0x34, 0x0F, 0x07, 0x17, 0x27,
+             0x0F, 0x0A, 0x1A, 0x2A, 0x0F, 0x05, 0x15, 0x25});
+
+    const std::vector<u8> &code = a.finish();
+    if (code.size() > 0x1000)
+        throw std::runtime_error("[TEST]: Программа не влезает в 4 КБ");
+
+    /* Каждый банк по 8 КБ: программа, свои данные с $1000, векторы */
+    std::vector<u8> prg(layout.prgSize, 0);
+    std::mt19937 rng(7);
+    for (sz bank = 0; bank < prg.size(); bank += 0x2000) {
+        const auto base = prg.begin() + static_cast<std::ptrdiff_t>(bank);
+        std::copy(code.begin(), code.end(), base);
+        for (sz i = 0x1000; i < 0x1F00; ++i)
+            base[static_cast<std::ptrdiff_t>(i)] =
+                static_cast<u8>(rng() & 0xFF);
+
+        const auto vector = [&](sz pos, u16 addr) {
+            prg[bank + pos] = static_cast<u8>(addr & 0xFF);
+            prg[bank + pos + 1] = static_cast<u8>(addr >> 8);
+        };
+        vector(0x1FFA, a.at("nmi"));
+        vector(0x1FFC, a.at("reset"));
+        vector(0x1FFE, a.at("irq"));
+    }
+
+    /* CHR: шум с прозрачными тайлами, тайл 1 каждого 1 КБ сплошной
+     * (sprite-0 hit при любом банке) */
+    std::vector<u8> chr(layout.chrSize);
+    for (u8 &b : chr)
+        b = static_cast<u8>(rng() & 0xFF);
+    for (sz tile = 0; tile < chr.size() / 16; tile += 5)
+        std::fill_n(chr.begin() + static_cast<std::ptrdiff_t>(tile * 16), 16,
+                    u8{0});
+    for (sz base = 0; base < chr.size(); base += 0x400)
+        std::fill_n(chr.begin() + static_cast<std::ptrdiff_t>(base + 16), 16,
+                    u8{0xFF});
+
+    /* iNES: PRG по 16 КБ, CHR по 8 КБ, vertical mirroring */
+    std::vector<u8> rom = {'N', 'E', 'S', 0x1A};
+    rom.push_back(static_cast<u8>(layout.prgSize / 0x4000));
+    rom.push_back(static_cast<u8>(layout.chrSize / 0x2000));
+    rom.push_back(static_cast<u8>((opt.mapper << 4) | 0x01));
+    rom.push_back(static_cast<u8>(opt.mapper & 0xF0));
+    rom.resize(16, 0);
+    rom.insert(rom.end(), prg.begin(), prg.end());
+    rom.insert(rom.end(), chr.begin(), chr.end());
+    return rom;
+}
+
+/* ROM во временном файле: Console::loadRom() читает с диска */
+inline auto writeRom(const std::string &name, const RomOptions &opt = {})
+    -> std::filesystem::path {
+    const auto path =
+        std::filesystem::temp_directory_path() / ("nespp-" + name + ".nes");
+    const std::vector<u8> rom = buildRom(opt);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(rom.data()),
+              static_cast<std::streamsize>(rom.size()));
+    if (!out)
+        throw std::runtime_error("[TEST]: Не удалось записать " +
+                                 path.string());
+    return path;
+}
+
+/* Ввод тестов: детерминированный, но меняется каждый кадр */
+inline u8 joyInput(u64 frame, u8 salt = 0) {
+    return static_cast<u8>((frame * 37u + (frame >> 3) + salt) & 0xFF);
+}
+
+} /* namespace Test */
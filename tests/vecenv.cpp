@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/console.h"
+#include "core/vecenv.h"
+
+#include "rom.h"
+
+/* Core::VecEnv против отдельных консолей с тем же вводом: у каждой
+ * консоли пачки на каждом кадре тот же хэш состояния, те же наблюдение и
+ * RAM. Посреди прогона одна консоль сбрасывается reset(i) - её пара
+ * загружает ROM заново. Код выхода ненулевой при первом расхождении
+ * каждого ROM-а.
+ */
+namespace {
+constexpr sz ENVS = 4;
+constexpr u64 FRAMES = 120;
+constexpr u64 RESET_FRAME = 50;
+constexpr sz RESET_ENV = 2;
+
+auto boot(const std::filesystem::path &romPath)
+    -> std::unique_ptr<Core::Console> {
+    auto console = std::make_unique<Core::Console>();
+    console->loadRom(romPath, NESPP_MAPPER_DIR);
+    console->ppu->indexedOutput = true;
+    return console;
+}
+
+/* У каждой консоли свой ввод */
+auto envInput(sz env, u64 frame, u8 pad) -> u8 {
+    return Test::joyInput(frame, static_cast<u8>(pad + env * 0x11));
+}
+
+bool fail(const std::string &rom, const std::string &what, sz env,
+          u64 frame) {
+    std::fprintf(stderr, "FAIL %s: env %zu %s (frame %llu)\n", rom.c_str(),
+                 env, what.c_str(), static_cast<unsigned long long>(frame));
+    return false;
+}
+
+bool sameObservation(const Core::VecEnv &envs, sz env,
+                     const Core::Console &console) {
+    const u8 *obs = envs.observations() + env * envs.obsSize();
+    const auto &frame = console.ppu->indexFrame;
+    for (sz i = 0; i < frame.size(); ++i) {
+        if (obs[i] != (frame[i] & 0x3F))
+            return false;
+    }
+
+    const u8 *ram = envs.ram() + env * Core::VecEnv::RAM_SIZE;
+    const auto &expected = console.mem->getState().ram;
+    return std::equal(ram, ram + Core::VecEnv::RAM_SIZE, expected.begin());
+}
+
+bool compare(const std::string &name, const Test::RomOptions &options) {
+    const auto romPath = Test::writeRom("vecenv-" + name, options);
+
+    Core::VecEnv::Config config;
+    config.count = ENVS;
+    config.threads = 2;
+    Core::VecEnv envs(romPath, NESPP_MAPPER_DIR, config);
+
+    std::vector<std::unique_ptr<Core::Console>> solo;
+    for (sz i = 0; i < ENVS; ++i)
+        solo.push_back(boot(romPath));
+
+    std::vector<u8> joy1(ENVS);
+    std::vector<u8> joy2(ENVS);
+    for (u64 f = 0; f < FRAMES; ++f) {
+        if (f == RESET_FRAME) {
+            envs.reset(RESET_ENV);
+            solo[RESET_ENV] = boot(romPath);
+        }
+
+        for (sz i = 0; i < ENVS; ++i) {
+            joy1[i] = envInput(i, f, 0);
+            joy2[i] = envInput(i, f, 0x5A);
+            solo[i]->setJoy1(joy1[i]);
+            solo[i]->setJoy2(joy2[i]);
+            if (!solo[i]->runFrame())
+                return fail(name, "standalone runFrame", i, f);
+        }
+        envs.step(joy1.data(), joy2.data());
+
+        for (sz i = 0; i < ENVS; ++i) {
+            if (envs.stalled(i))
+                return fail(name, "stalled", i, f);
+            if (envs.console(i).stateHash() != solo[i]->stateHash())
+                return fail(name, "state diverged", i, f);
+            if (!sameObservation(envs, i, *solo[i]))
+                return fail(name, "observation differs", i, f);
+        }
+    }
+
+    return true;
+}
+} /* namespace */
+
+int main() {
+    Test::RomOptions mmc3;
+    mmc3.mapper = 4;
+
+    int failures = 0;
+    try {
+        if (!compare("nrom", {}))
+            ++failures;
+        if (!compare("mmc3", mmc3))
+            ++failures;
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if (failures != 0)
+        return EXIT_FAILURE;
+
+    std::printf("vecenv: ok\n");
+    return EXIT_SUCCESS;
+}